@@ -21,6 +21,7 @@
 #include "qofonoextmodemlistmodel.h"
 #include "qofonoextcellinfo.h"
 #include "qofonoextcell.h"
+#include "qofonoextcellhistory.h"
 
 #include <QtQml>
 
@@ -33,6 +34,7 @@ void QOfonoExtDeclarativePlugin::registerTypes(const char* aUri, int aMajor, int
     qmlRegisterType<QOfonoExtSimListModel>(aUri, aMajor, aMinor, "OfonoExtSimListModel");
     qmlRegisterType<QOfonoExtCellInfo>(aUri, aMajor, aMinor, "OfonoExtCellInfo");
     qmlRegisterType<QOfonoExtCell>(aUri, aMajor, aMinor, "OfonoExtCell");
+    qmlRegisterType<QOfonoExtCellHistory>(aUri, aMajor, aMinor, "OfonoExtCellHistory");
 }
 
 void QOfonoExtDeclarativePlugin::registerTypes(const char* aUri)
@@ -0,0 +1,112 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include "qofonoextlistupdate.h"
+
+#include <QSet>
+#include <QVector>
+
+#include <algorithm>
+
+QOfonoExtListUpdate::QOfonoExtListUpdate(QStringList aRows) :
+    iRows(aRows)
+{
+    iIndex.reserve(iRows.count());
+    updateIndex(0, iRows.count() - 1);
+}
+
+void QOfonoExtListUpdate::updateIndex(int aFrom, int aTo)
+{
+    for (int i=aFrom; i<=aTo; i++) {
+        iIndex.insert(iRows.at(i), i);
+    }
+}
+
+int QOfonoExtListUpdate::row(const QString& aKey) const
+{
+    return iIndex.value(aKey, -1);
+}
+
+QVector<int> QOfonoExtListUpdate::longestIncreasing(const QVector<int>& aValues)
+{
+    // Patience sorting. tails[k] is the index of the smallest value
+    // ending an increasing subsequence of length k+1, tailValues[k]
+    // is that value.
+    const int n = aValues.count();
+    QVector<int> tails, tailValues, prev(n);
+    tails.reserve(n);
+    tailValues.reserve(n);
+    for (int i=0; i<n; i++) {
+        const int k = std::lower_bound(tailValues.begin(), tailValues.end(),
+            aValues.at(i)) - tailValues.begin();
+        prev[i] = k ? tails.at(k-1) : -1;
+        if (k == tails.count()) {
+            tails.append(i);
+            tailValues.append(aValues.at(i));
+        } else {
+            tails[k] = i;
+            tailValues[k] = aValues.at(i);
+        }
+    }
+
+    QVector<int> result(tails.count());
+    int i = tails.isEmpty() ? -1 : tails.last();
+    for (int k=result.count()-1; k>=0; k--, i=prev.at(i)) {
+        result[k] = i;
+    }
+    return result;
+}
+
+void QOfonoExtListUpdate::apply(const QStringList& aNewRows,
+    InsertFunc aInsert, MoveFunc aMove)
+{
+    int i;
+    const int n = aNewRows.count();
+    const int m = iRows.count();
+    QHash<QString,int> newPos;
+    newPos.reserve(n);
+    for (i=0; i<n; i++) {
+        newPos.insert(aNewRows.at(i), i);
+    }
+
+    // The longest increasing run of new positions stays
+    QVector<int> pos(m);
+    for (i=0; i<m; i++) {
+        pos[i] = newPos.value(iRows.at(i));
+    }
+    const QVector<int> lis(longestIncreasing(pos));
+    QSet<QString> stay;
+    stay.reserve(lis.count());
+    for (i=0; i<lis.count(); i++) {
+        stay.insert(iRows.at(lis.at(i)));
+    }
+
+    for (i=0; i<n; i++) {
+        const QString& key(aNewRows.at(i));
+        if (!stay.contains(key)) {
+            const int dest = i ? (row(aNewRows.at(i-1)) + 1) : 0;
+            const int from = row(key);
+            if (from < 0) {
+                aInsert(i, dest);
+                iRows.insert(dest, key);
+                updateIndex(dest, iRows.count() - 1);
+            } else if (from != dest) {
+                const int to = (dest > from) ? (dest - 1) : dest;
+                aMove(from, dest);
+                iRows.move(from, to);
+                updateIndex(qMin(from, to), qMax(from, to));
+            }
+        }
+    }
+}
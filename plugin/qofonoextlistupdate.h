@@ -0,0 +1,64 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef QOFONOEXTLISTUPDATE_H
+#define QOFONOEXTLISTUPDATE_H
+
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+// Brings the rows of a list model into the new order with the fewest
+// inserts and moves, so that views keep the delegates of the rows that
+// stay. Rows are identified by unique keys (modem paths). The rows that
+// are gone must have been removed already, every remaining key must be
+// in the new list.
+//
+// The longest subsequence of the current rows which is already in the
+// right order stays put, everything else is inserted or moved right
+// after its predecessor in the new list. The model makes the actual
+// change in the callbacks:
+//
+//   aInsert(aIndex, aRow) inserts the item at aIndex of the new list
+//   at aRow, between beginInsertRows() and endInsertRows()
+//
+//   aMove(aRow, aDest) moves aRow before aDest (before it is removed),
+//   between beginMoveRows() and endMoveRows()
+class QOfonoExtListUpdate
+{
+public:
+    typedef std::function<void(int aIndex, int aRow)> InsertFunc;
+    typedef std::function<void(int aRow, int aDest)> MoveFunc;
+
+    QOfonoExtListUpdate(QStringList aRows);
+
+    void apply(const QStringList& aNewRows, InsertFunc aInsert, MoveFunc aMove);
+
+    // Row of the key, -1 if there's no such row
+    int row(const QString& aKey) const;
+
+    // Indices of the longest strictly increasing subsequence of aValues
+    static QVector<int> longestIncreasing(const QVector<int>& aValues);
+
+private:
+    void updateIndex(int aFrom, int aTo);
+
+private:
+    QStringList iRows;
+    QHash<QString,int> iIndex;
+};
+
+#endif // QOFONOEXTLISTUPDATE_H
@@ -14,15 +14,26 @@
 ****************************************************************************/
 
 #include "qofonoextmodemlistmodel.h"
+#include "qofonoextlistupdate.h"
 
 QOfonoExtModemListModel::QOfonoExtModemListModel(QObject* aParent) :
     QAbstractListModel(aParent),
     iModemManager(QOfonoExtModemManager::instance()),
-    iAvailableModems(iModemManager->availableModems()),
     iEnabledModems(iModemManager->enabledModems()),
     iDefaultVoiceModem(iModemManager->defaultVoiceModem()),
-    iDefaultDataModem(iModemManager->defaultDataModem())
+    iDefaultDataModem(iModemManager->defaultDataModem()),
+    iDefaultVoiceRow(-1),
+    iDefaultDataRow(-1)
 {
+    const QStringList modems(iModemManager->availableModems());
+    const int n = modems.count();
+    iRows.reserve(n);
+    for (int i=0; i<n; i++) {
+        iRows.append(newRow(modems.at(i)));
+    }
+    updateRowIndex();
+    updateIndexedValues();
+
     connect(iModemManager.data(),
         SIGNAL(validChanged(bool)),
         SLOT(onValidChanged(bool)));
@@ -49,6 +60,60 @@ QOfonoExtModemListModel::QOfonoExtModemListModel(QObject* aParent) :
         SLOT(onImeisvCodesChanged(QStringList)));
 }
 
+QOfonoExtModemListModel::Row QOfonoExtModemListModel::newRow(QString aPath) const
+{
+    // The index based values get filled in by updateIndexedValues()
+    Row row;
+    row.path = aPath;
+    row.enabled = iEnabledModems.contains(aPath);
+    row.defaultData = (aPath == iDefaultDataModem);
+    row.defaultVoice = (aPath == iDefaultVoiceModem);
+    row.simPresent = false;
+    return row;
+}
+
+void QOfonoExtModemListModel::updateRowIndex()
+{
+    const int n = iRows.count();
+    iRowIndex.clear();
+    iRowIndex.reserve(n);
+    for (int i=0; i<n; i++) {
+        iRowIndex.insert(iRows.at(i).path, i);
+    }
+    iDefaultDataRow = iRowIndex.value(iDefaultDataModem, -1);
+    iDefaultVoiceRow = iRowIndex.value(iDefaultVoiceModem, -1);
+}
+
+void QOfonoExtModemListModel::updateIndexedValues()
+{
+    // SIM presence and IMEIs are stored by modem index
+    QVector<int> roles;
+    const int n = iRows.count();
+    for (int i=0; i<n; i++) {
+        Row& row = iRows[i];
+        const bool simPresent = iModemManager->simPresentAt(i);
+        const QString imei(iModemManager->imeiAt(i));
+        const QString imeisv(iModemManager->imeisvAt(i));
+        roles.resize(0);
+        if (row.simPresent != simPresent) {
+            row.simPresent = simPresent;
+            roles.append(SimPresentRole);
+        }
+        if (row.imei != imei) {
+            row.imei = imei;
+            roles.append(IMEIRole);
+        }
+        if (row.imeisv != imeisv) {
+            row.imeisv = imeisv;
+            roles.append(IMEISVRole);
+        }
+        if (!roles.isEmpty()) {
+            QModelIndex index(createIndex(i, 0));
+            Q_EMIT dataChanged(index, index, roles);
+        }
+    }
+}
+
 bool QOfonoExtModemListModel::valid() const
 {
     return iModemManager->valid();
@@ -56,7 +121,7 @@ bool QOfonoExtModemListModel::valid() const
 
 int QOfonoExtModemListModel::count() const
 {
-    return iAvailableModems.count();
+    return iRows.count();
 }
 
 QHash<int,QByteArray> QOfonoExtModemListModel::roleNames() const
@@ -74,21 +139,22 @@ QHash<int,QByteArray> QOfonoExtModemListModel::roleNames() const
 
 int QOfonoExtModemListModel::rowCount(const QModelIndex& aParent) const
 {
-    return iAvailableModems.count();
+    return iRows.count();
 }
 
 QVariant QOfonoExtModemListModel::data(const QModelIndex& aIndex, int aRole) const
 {
     const int row = aIndex.row();
-    if (row >= 0 && row < iAvailableModems.count()) {
+    if (row >= 0 && row < iRows.count()) {
+        const Row& state = iRows.at(row);
         switch (aRole) {
-        case PathRole:         return iAvailableModems.at(row);
-        case EnabledRole:      return iEnabledModems.contains(iAvailableModems.at(row));
-        case DefaultDataRole:  return iAvailableModems.indexOf(iDefaultDataModem) == row;
-        case DefaultVoiceRole: return iAvailableModems.indexOf(iDefaultVoiceModem) == row;
-        case SimPresentRole:   return iModemManager->simPresentAt(row);
-        case IMEIRole:         return iModemManager->imeiAt(row);
-        case IMEISVRole:       return iModemManager->imeisvAt(row);
+        case PathRole:         return state.path;
+        case EnabledRole:      return state.enabled;
+        case DefaultDataRole:  return state.defaultData;
+        case DefaultVoiceRole: return state.defaultVoice;
+        case SimPresentRole:   return state.simPresent;
+        case IMEIRole:         return state.imei;
+        case IMEISVRole:       return state.imeisv;
         }
     }
     qWarning() << aIndex << aRole;
@@ -98,16 +164,15 @@ QVariant QOfonoExtModemListModel::data(const QModelIndex& aIndex, int aRole) con
 bool QOfonoExtModemListModel::setData(const QModelIndex& aIndex, const QVariant& aValue, int aRole)
 {
     const int row = aIndex.row();
-    if (row >= 0 && row < iAvailableModems.count() && aRole == EnabledRole) {
+    if (row >= 0 && row < iRows.count() && aRole == EnabledRole) {
         const bool enabled = aValue.toBool();
-        const QString& path(iAvailableModems.at(row));
-        const int index = iEnabledModems.indexOf(path);
-        if (enabled != (index >= 0)) {
+        if (enabled != iRows.at(row).enabled) {
+            const QString& path(iRows.at(row).path);
             QStringList enabledModems = iEnabledModems;
             if (enabled) {
                 enabledModems.append(path);
             } else {
-                enabledModems.removeAt(index);
+                enabledModems.removeAll(path);
             }
             iModemManager->setEnabledModems(enabledModems);
         }
@@ -118,35 +183,91 @@ bool QOfonoExtModemListModel::setData(const QModelIndex& aIndex, const QVariant&
 
 void QOfonoExtModemListModel::onValidChanged(bool aValid)
 {
-    if (aValid) {
-        beginResetModel();
-        endResetModel();
+    if (aValid && !iRows.isEmpty()) {
+        // The rows stay, only the values may have changed
+        Q_EMIT dataChanged(createIndex(0, 0), createIndex(iRows.count() - 1, 0));
     }
     Q_EMIT validChanged(aValid);
 }
 
 void QOfonoExtModemListModel::onAvailableModemsChanged(QStringList aModems)
 {
-    const bool countHasChanged = iAvailableModems.count() != aModems.count();
-    beginResetModel();
-    iAvailableModems = aModems;
-    endResetModel();
-    if (countHasChanged) {
-        Q_EMIT countChanged(iAvailableModems.count());
+    const int prevCount = iRows.count();
+    updateRows(aModems);
+    if (prevCount != iRows.count()) {
+        Q_EMIT countChanged(iRows.count());
     }
 }
 
+void QOfonoExtModemListModel::updateRows(QStringList aModems)
+{
+    int i;
+    const int n = aModems.count();
+    QHash<QString,int> newRows;
+    newRows.reserve(n);
+    for (i=0; i<n; i++) {
+        newRows.insert(aModems.at(i), i);
+    }
+
+    // Remove the modems that are gone
+    for (i=iRows.count()-1; i>=0; i--) {
+        if (!newRows.contains(iRows.at(i).path)) {
+            beginRemoveRows(QModelIndex(), i, i);
+            iRows.remove(i);
+            endRemoveRows();
+        }
+    }
+
+    // The remaining rows are a subset of the new list
+    QStringList paths;
+    const int m = iRows.count();
+    paths.reserve(m);
+    for (i=0; i<m; i++) {
+        paths.append(iRows.at(i).path);
+    }
+    QOfonoExtListUpdate(paths).apply(aModems,
+        [this,&aModems](int aIndex, int aRow) {
+            beginInsertRows(QModelIndex(), aRow, aRow);
+            iRows.insert(aRow, newRow(aModems.at(aIndex)));
+            endInsertRows();
+        },
+        [this](int aRow, int aDest) {
+            beginMoveRows(QModelIndex(), aRow, aRow, QModelIndex(), aDest);
+            iRows.move(aRow, (aDest > aRow) ? (aDest - 1) : aDest);
+            endMoveRows();
+        });
+
+    if (iRows.count() != n) {
+        // Shouldn't happen (duplicate paths?)
+        beginResetModel();
+        iRows.resize(0);
+        for (i=0; i<n; i++) {
+            iRows.append(newRow(aModems.at(i)));
+        }
+        endResetModel();
+    }
+
+    updateRowIndex();
+    updateIndexedValues();
+}
+
 void QOfonoExtModemListModel::onEnabledModemsChanged(QStringList aModems)
 {
     if (iEnabledModems != aModems) {
-        QStringList prevModems = iEnabledModems;
         iEnabledModems = aModems;
-        const int n = iAvailableModems.count();
         QVector<int> role;
         role.append(EnabledRole);
-        for (int i=0; i<n; i++) {
-            const QString& path(iAvailableModems.at(i));
-            if (prevModems.contains(path) != aModems.contains(path)) {
+        QSet<QString> enabled;
+        int i;
+        for (i=0; i<aModems.count(); i++) {
+            enabled.insert(aModems.at(i));
+        }
+        const int n = iRows.count();
+        for (i=0; i<n; i++) {
+            Row& row = iRows[i];
+            const bool rowEnabled = enabled.contains(row.path);
+            if (row.enabled != rowEnabled) {
+                row.enabled = rowEnabled;
                 QModelIndex index(createIndex(i, 0));
                 Q_EMIT dataChanged(index, index, role);
             }
@@ -156,24 +277,41 @@ void QOfonoExtModemListModel::onEnabledModemsChanged(QStringList aModems)
 
 void QOfonoExtModemListModel::onDefaultDataModemChanged(QString aModemPath)
 {
-    const int prevIndex = iAvailableModems.indexOf(iDefaultDataModem);
+    const int prevRow = iDefaultDataRow;
     iDefaultDataModem = aModemPath;
-    defaultModemChanged(DefaultDataRole, prevIndex, iAvailableModems.indexOf(aModemPath));
+    iDefaultDataRow = iRowIndex.value(aModemPath, -1);
+    if (prevRow >= 0) {
+        iRows[prevRow].defaultData = false;
+    }
+    if (iDefaultDataRow >= 0) {
+        iRows[iDefaultDataRow].defaultData = true;
+    }
+    defaultModemChanged(DefaultDataRole, prevRow, iDefaultDataRow);
 }
 
 void QOfonoExtModemListModel::onDefaultVoiceModemChanged(QString aModemPath)
 {
-    const int prevIndex = iAvailableModems.indexOf(iDefaultVoiceModem);
+    const int prevRow = iDefaultVoiceRow;
     iDefaultVoiceModem = aModemPath;
-    defaultModemChanged(DefaultVoiceRole, prevIndex, iAvailableModems.indexOf(aModemPath));
+    iDefaultVoiceRow = iRowIndex.value(aModemPath, -1);
+    if (prevRow >= 0) {
+        iRows[prevRow].defaultVoice = false;
+    }
+    if (iDefaultVoiceRow >= 0) {
+        iRows[iDefaultVoiceRow].defaultVoice = true;
+    }
+    defaultModemChanged(DefaultVoiceRole, prevRow, iDefaultVoiceRow);
 }
 
 void QOfonoExtModemListModel::onPresentSimChanged(int aIndex, bool aPresent)
 {
-    QVector<int> role;
-    role.append(SimPresentRole);
-    QModelIndex index(createIndex(aIndex, 0));
-    Q_EMIT dataChanged(index, index, role);
+    if (aIndex >= 0 && aIndex < iRows.count() && iRows.at(aIndex).simPresent != aPresent) {
+        iRows[aIndex].simPresent = aPresent;
+        QVector<int> role;
+        role.append(SimPresentRole);
+        QModelIndex index(createIndex(aIndex, 0));
+        Q_EMIT dataChanged(index, index, role);
+    }
 }
 
 void QOfonoExtModemListModel::defaultModemChanged(Role aRole, int aPrevRow, int aNewRow)
@@ -194,29 +332,28 @@ void QOfonoExtModemListModel::defaultModemChanged(Role aRole, int aPrevRow, int
 
 void QOfonoExtModemListModel::onImeiCodesChanged(QStringList aList)
 {
-    QStringList prev = iImeiList;
-    iImeiList = aList;
-    roleChanged(IMEIRole, prev, aList);
+    QVector<int> role;
+    role.append(IMEIRole);
+    const int n = iRows.count();
+    for (int i=0; i<n; i++) {
+        const QString imei(aList.value(i));
+        if (iRows.at(i).imei != imei) {
+            iRows[i].imei = imei;
+            QModelIndex index(createIndex(i, 0));
+            Q_EMIT dataChanged(index, index, role);
+        }
+    }
 }
 
 void QOfonoExtModemListModel::onImeisvCodesChanged(QStringList aList)
 {
-    QStringList prev = iImeisvList;
-    iImeisvList = aList;
-    roleChanged(IMEISVRole, prev, aList);
-}
-
-void QOfonoExtModemListModel::roleChanged(Role aRole, QStringList aPrevList, QStringList aNewList)
-{
-    // This is slightly paranoid... All these 3 counts should be the same
-    const int n1 = iAvailableModems.count();
-    const int n2 = aPrevList.count();
-    const int n3 = aNewList.count();
-    const int n = qMin(n1, qMin(n2, n3));
     QVector<int> role;
-    role.append(aRole);
+    role.append(IMEISVRole);
+    const int n = iRows.count();
     for (int i=0; i<n; i++) {
-        if (aPrevList.at(i) != aNewList.at(i)) {
+        const QString imeisv(aList.value(i));
+        if (iRows.at(i).imeisv != imeisv) {
+            iRows[i].imeisv = imeisv;
             QModelIndex index(createIndex(i, 0));
             Q_EMIT dataChanged(index, index, role);
         }
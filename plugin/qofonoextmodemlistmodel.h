@@ -61,17 +61,31 @@ private Q_SLOTS:
     void onImeisvCodesChanged(QStringList aList);
 
 private:
+    struct Row {
+        QString path;
+        bool enabled;
+        bool defaultData;
+        bool defaultVoice;
+        bool simPresent;
+        QString imei;
+        QString imeisv;
+    };
+
+    Row newRow(QString aPath) const;
+    void updateRowIndex();
+    void updateIndexedValues();
+    void updateRows(QStringList aModems);
     void defaultModemChanged(Role aRole, int aPrevRow, int aNewRow);
-    void roleChanged(Role aRole, QStringList aPrevList, QStringList aNewList);
 
 private:
     QSharedPointer<QOfonoExtModemManager> iModemManager;
-    QStringList iAvailableModems;
+    QVector<Row> iRows;
+    QHash<QString,int> iRowIndex;
     QStringList iEnabledModems;
     QString iDefaultVoiceModem;
     QString iDefaultDataModem;
-    QStringList iImeiList;
-    QStringList iImeisvList;
+    int iDefaultVoiceRow;
+    int iDefaultDataRow;
 };
 
 #endif // QOFONOEXTMODEMLISTMODEL_H
@@ -14,6 +14,7 @@
 ****************************************************************************/
 
 #include "qofonoextsimlistmodel.h"
+#include "qofonoextlistupdate.h"
 #include <QQmlEngine>
 
 class QOfonoExtSimListModel::SimData : public QObject {
@@ -46,6 +47,10 @@ private:
     void propertyChanged(Role role);
     bool isValid() const;
     int slotNumber() const;
+    QVariant roleValue(Role aRole) const;
+
+public:
+    QVariant value(Role aRole) const;
 
 public:
     QOfonoExtSimListModel* iParent;
@@ -55,6 +60,12 @@ public:
     int iIndex;
     int iSlot;
     bool iValid;
+
+private:
+    // Role values are built on demand and kept until the matching
+    // change signal arrives
+    mutable QVariant iValues[LastRole - FirstRole + 1];
+    mutable quint32 iValueMask;
 };
 
 QOfonoExtSimListModel::SimData::SimData(QOfonoExtSimListModel* aParent,
@@ -65,7 +76,8 @@ QOfonoExtSimListModel::SimData::SimData(QOfonoExtSimListModel* aParent,
     iModemManager(aModemManager),
     iSim(aSimManager),
     iCache(new QOfonoExtSimInfo(this)),
-    iIndex(aIndex)
+    iIndex(aIndex),
+    iValueMask(0)
 {
     iSlot = slotNumber();
     iValid = isValid();
@@ -123,8 +135,45 @@ QOfonoExtSimListModel::SimData::SimData(QOfonoExtSimListModel* aParent,
         SLOT(onBarredDialingChanged()));
 }
 
+QVariant QOfonoExtSimListModel::SimData::value(Role aRole) const
+{
+    const quint32 bit = 1u << (aRole - FirstRole);
+    QVariant& value = iValues[aRole - FirstRole];
+    if (!(iValueMask & bit)) {
+        value = roleValue(aRole);
+        iValueMask |= bit;
+    }
+    return value;
+}
+
+QVariant QOfonoExtSimListModel::SimData::roleValue(Role aRole) const
+{
+    switch (aRole) {
+    case SlotRole:                return iSlot;
+    case ValidRole:               return iValid;
+    case PathRole:                return iSim->modemPath();
+    case MobileCountryCodeRole:   return iSim->mobileCountryCode();
+    case MobileNetworkCodeRole:   return iSim->mobileNetworkCode();
+    case SubscriberNumbersRole:   return iSim->subscriberNumbers();
+    case ServiceNumbersRole:      return iSim->serviceNumbers();
+    case PinRequiredRole:         return iSim->pinRequired();
+    case LockedPinsRole:          return iSim->lockedPins();
+    case CardIdentifierRole:      return iSim->cardIdentifier();
+    case PreferredLanguagesRole:  return iSim->preferredLanguages();
+    case PinRetriesRole:          return iSim->pinRetries();
+    case FixedDialingRole:        return iSim->fixedDialing();
+    case BarredDialingRole:       return iSim->barredDialing();
+    case SubscriberIdentityRole:  return iCache->subscriberIdentity();
+    case ServiceProviderNameRole: return iCache->serviceProviderName();
+    }
+    return QVariant();
+}
+
 void QOfonoExtSimListModel::SimData::propertyChanged(Role role)
 {
+    // Drop the cached value
+    iValueMask &= ~(1u << (role - FirstRole));
+    iValues[role - FirstRole] = QVariant();
     if (iIndex >= 0) {
         QModelIndex modelIndex = iParent->index(iIndex);
         QVector<int> roles;
@@ -293,24 +342,8 @@ QVariant QOfonoExtSimListModel::data(const QModelIndex& aIndex, int aRole) const
 {
     const int row = aIndex.row();
     if (row >= 0 && row < iSimList.count()) {
-        const SimData* d = iSimList.at(row);
-        switch (aRole) {
-        case SlotRole:                return d->iSlot;
-        case ValidRole:               return d->iValid;
-        case PathRole:                return d->iSim->modemPath();
-        case MobileCountryCodeRole:   return d->iSim->mobileCountryCode();
-        case MobileNetworkCodeRole:   return d->iSim->mobileNetworkCode();
-        case SubscriberNumbersRole:   return d->iSim->subscriberNumbers();
-        case ServiceNumbersRole:      return d->iSim->serviceNumbers();
-        case PinRequiredRole:         return d->iSim->pinRequired();
-        case LockedPinsRole:          return d->iSim->lockedPins();
-        case CardIdentifierRole:      return d->iSim->cardIdentifier();
-        case PreferredLanguagesRole:  return d->iSim->preferredLanguages();
-        case PinRetriesRole:          return d->iSim->pinRetries();
-        case FixedDialingRole:        return d->iSim->fixedDialing();
-        case BarredDialingRole:       return d->iSim->barredDialing();
-        case SubscriberIdentityRole:  return d->iCache->subscriberIdentity();
-        case ServiceProviderNameRole: return d->iCache->serviceProviderName();
+        if (aRole >= FirstRole && aRole <= LastRole) {
+            return iSimList.at(row)->value((Role)aRole);
         }
     } else {
         qWarning() << aIndex << aRole;
@@ -324,37 +357,59 @@ void QOfonoExtSimListModel::onPresentSimListChanged()
     if (iSimWatcher->isValid()) {
         sims = iSimWatcher->presentSimList();
     }
-    const bool countHasChanged(iSimList.count() != sims.count());
+    const int prevCount = iSimList.count();
     const bool wasValid = iValid;
-    QStringList paths;
+    const int n = sims.count();
+    QHash<QString,int> newRows;
     int i;
-    for (i=0; i<sims.count(); i++) {
-        paths.append(sims.at(i)->modemPath());
+    newRows.reserve(n);
+    for (i=0; i<n; i++) {
+        newRows.insert(sims.at(i)->modemPath(), i);
     }
+
     // Remove stale entries
     for (i=iSimList.count()-1; i>=0; i--) {
-        QString path(iSimList.at(i)->iSim->modemPath());
-        if (!paths.contains(path)) {
+        const SimData* data = iSimList.at(i);
+        const QString path(data->iSim->modemPath());
+        const int newRow = newRows.value(path, -1);
+        if (newRow < 0 || sims.at(newRow) != data->iSim) {
             beginRemoveRows(QModelIndex(), i, i);
             delete iSimList.takeAt(i);
             endRemoveRows();
             Q_EMIT simRemoved(path);
         }
     }
-    // Add new entries
-    for (i=0; i<sims.count(); i++) {
-        if (iSimList.count() <= i ||
-            iSimList.at(i)->iSim->modemPath() != paths.at(i)) {
-            SimData* data = new SimData(this, iModemManager, sims.at(i), i);
-            beginInsertRows(QModelIndex(), i, i);
-            iSimList.insert(i, data);
+
+    // Insert new entries and move the existing ones into place.
+    // Existing SimData objects are reused.
+    QStringList paths, newPaths;
+    const int m = iSimList.count();
+    paths.reserve(m);
+    for (i=0; i<m; i++) {
+        paths.append(iSimList.at(i)->iSim->modemPath());
+    }
+    newPaths.reserve(n);
+    for (i=0; i<n; i++) {
+        newPaths.append(sims.at(i)->modemPath());
+    }
+    QOfonoExtListUpdate(paths).apply(newPaths,
+        [this,&sims](int aIndex, int aRow) {
+            SimData* data = new SimData(this, iModemManager, sims.at(aIndex), aRow);
+            beginInsertRows(QModelIndex(), aRow, aRow);
+            iSimList.insert(aRow, data);
             endInsertRows();
             Q_EMIT simAdded(data->iCache);
-        } else {
-            iSimList.at(i)->iIndex = i;
-        }
+        },
+        [this](int aRow, int aDest) {
+            beginMoveRows(QModelIndex(), aRow, aRow, QModelIndex(), aDest);
+            iSimList.move(aRow, (aDest > aRow) ? (aDest - 1) : aDest);
+            endMoveRows();
+        });
+
+    for (i=0; i<iSimList.count(); i++) {
+        iSimList.at(i)->iIndex = i;
     }
-    if (countHasChanged) {
+    if (prevCount != iSimList.count()) {
         Q_EMIT countChanged();
     }
     iValid = isValid();
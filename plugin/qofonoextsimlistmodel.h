@@ -42,7 +42,9 @@ public:
         PreferredLanguagesRole,
         PinRetriesRole,
         FixedDialingRole,
-        BarredDialingRole
+        BarredDialingRole,
+        FirstRole = PathRole,
+        LastRole = BarredDialingRole
     };
 
     explicit QOfonoExtSimListModel(QObject* aParent = NULL);
@@ -14,7 +14,10 @@ BuildRequires:  pkgconfig
 BuildRequires:  pkgconfig(Qt6Core)
 BuildRequires:  pkgconfig(Qt6DBus)
 BuildRequires:  pkgconfig(Qt6Quick)
+BuildRequires:  pkgconfig(Qt6Test)
 BuildRequires:  pkgconfig(qofono-qt6) >= %{libqofono_version}
+# dbus-daemon for the unit tests
+BuildRequires:  dbus
 
 # license macro requires rpm >= 4.11
 BuildRequires:  pkgconfig(rpm)
@@ -50,6 +53,9 @@ This package contains the development header files for %{name}
 %cmake . -DLIBQOFONOEXT_VERSION=$(sed 's/+.*//' <<<"%{version}") -DQT_MAJOR_VERSION=6
 %cmake_build
 
+%check
+%ctest -L unit
+
 %install
 %cmake_install
 
@@ -15,7 +15,10 @@ BuildRequires:  pkgconfig
 BuildRequires:  pkgconfig(Qt5Core)
 BuildRequires:  pkgconfig(Qt5DBus)
 BuildRequires:  pkgconfig(Qt5Quick)
+BuildRequires:  pkgconfig(Qt5Test)
 BuildRequires:  pkgconfig(qofono-qt5) >= %{libqofono_version}
+# dbus-daemon for the unit tests
+BuildRequires:  dbus
 
 # license macro requires rpm >= 4.11
 BuildRequires:  pkgconfig(rpm)
@@ -51,6 +54,9 @@ This package contains the development header files for %{name}
 %cmake . -DLIBQOFONOEXT_VERSION=$(sed 's/+.*//' <<<"%{version}")
 %cmake_build
 
+%check
+%ctest -L unit
+
 %install
 %cmake_install
 
@@ -15,6 +15,247 @@
 
 #include "qofonoext_p.h"
 
+QDBusConnection QOfonoExt::bus()
+{
+    static const QByteArray address(qgetenv("QOFONOEXT_BUS"));
+    if (address.isEmpty() || address == "system") {
+        return QDBusConnection::systemBus();
+    } else if (address == "session") {
+        return QDBusConnection::sessionBus();
+    } else {
+        // Returns the existing connection if it's already there
+        return QDBusConnection::connectToBus(QString::fromLocal8Bit(address),
+            QStringLiteral("qofonoext"));
+    }
+}
+
+// ==========================================================================
+// QOfonoExtProxy
+// ==========================================================================
+
+QOfonoExtProxy::QOfonoExtProxy(const QString& aPath, const QString& aInterface, QObject* aParent) :
+    QObject(aParent),
+    iPath(aPath),
+    iInterface(aInterface)
+{
+}
+
+QOfonoExtProxy::~QOfonoExtProxy()
+{
+    QDBusConnection bus(OFONO_BUS);
+    for (int i = 0; i < iSubscriptions.count(); i++) {
+        const Subscription& sub(iSubscriptions.at(i));
+        if (sub.iReceiver) {
+            bus.disconnect(OFONO_SERVICE, iPath, iInterface, sub.iSignal,
+                sub.iReceiver, sub.iSlot.constData());
+        }
+    }
+}
+
+QDBusPendingCall QOfonoExtProxy::asyncCall(const QString& aMethod) const
+{
+    return OFONO_BUS.asyncCall(QDBusMessage::createMethodCall(OFONO_SERVICE,
+        iPath, iInterface, aMethod));
+}
+
+QDBusMessage QOfonoExtProxy::call(const QString& aMethod) const
+{
+    return OFONO_BUS.call(QDBusMessage::createMethodCall(OFONO_SERVICE,
+        iPath, iInterface, aMethod));
+}
+
+bool QOfonoExtProxy::connectSignal(const QString& aSignal, QObject* aReceiver, const char* aSlot)
+{
+    if (OFONO_BUS.connect(OFONO_SERVICE, iPath, iInterface, aSignal, aReceiver, aSlot)) {
+        Subscription sub;
+        sub.iSignal = aSignal;
+        sub.iReceiver = aReceiver;
+        sub.iSlot = aSlot;
+        iSubscriptions.append(sub);
+        return true;
+    }
+    return false;
+}
+
+// ==========================================================================
+// QOfonoExtRetry::Scheduler
+// ==========================================================================
+
+class QOfonoExtRetry::Scheduler
+{
+public:
+    enum {
+        MinDelay = 500,     // ms
+        MaxDelay = 60000,   // ms
+        DefaultMaxActive = 4
+    };
+
+    Scheduler() : iMaxActive(DefaultMaxActive), iStats() {}
+
+    static int delay(int aAttempt);
+    void ready(QOfonoExtRetry* aRetry);
+    void startWaiting();
+
+public:
+    int iMaxActive;
+    QOfonoExtRetryStats iStats;
+    QList<QOfonoExtRetry*> iWaiting;
+};
+
+Q_GLOBAL_STATIC(QOfonoExtRetry::Scheduler, retryScheduler)
+
+int QOfonoExtRetry::Scheduler::delay(int aAttempt)
+{
+    // Exponential backoff with "equal jitter", i.e. somewhere between
+    // a half and the full interval so that the retries don't synchronize
+    const int max = (aAttempt < 16) ? qMin(MinDelay << aAttempt, (int)MaxDelay) : MaxDelay;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    const int jitter = QRandomGenerator::global()->bounded(max / 2 + 1);
+#else
+    const int jitter = qrand() % (max / 2 + 1);
+#endif
+    return max / 2 + jitter;
+}
+
+void QOfonoExtRetry::Scheduler::ready(QOfonoExtRetry* aRetry)
+{
+    if (iStats.active < iMaxActive) {
+        aRetry->start();
+    } else {
+        iWaiting.append(aRetry);
+        iStats.waiting = iWaiting.count();
+    }
+}
+
+void QOfonoExtRetry::Scheduler::startWaiting()
+{
+    while (iStats.active < iMaxActive && !iWaiting.isEmpty()) {
+        QOfonoExtRetry* retry = iWaiting.takeFirst();
+        iStats.waiting = iWaiting.count();
+        retry->start();
+    }
+}
+
+// ==========================================================================
+// QOfonoExtRetry
+// ==========================================================================
+
+QOfonoExtRetry::QOfonoExtRetry() :
+    iAttempt(0),
+    iActive(false),
+    iTimer(Q_NULLPTR)
+{
+}
+
+QOfonoExtRetry::~QOfonoExtRetry()
+{
+    if (!retryScheduler.isDestroyed()) {
+        cancel();
+    }
+    delete iTimer;
+}
+
+void QOfonoExtRetry::schedule(std::function<void()> aCall)
+{
+    Scheduler* scheduler = retryScheduler();
+    release();
+    if (scheduler->iWaiting.removeOne(this)) {
+        scheduler->iStats.waiting = scheduler->iWaiting.count();
+    }
+    if (!iTimer) {
+        iTimer = new QTimer;
+        iTimer->setSingleShot(true);
+        QObject::connect(iTimer, &QTimer::timeout, [this]() { onTimeout(); });
+    }
+    iCall = aCall;
+    iTimer->start(Scheduler::delay(iAttempt++));
+    scheduler->iStats.scheduled++;
+}
+
+void QOfonoExtRetry::onTimeout()
+{
+    retryScheduler()->ready(this);
+}
+
+void QOfonoExtRetry::start()
+{
+    Scheduler* scheduler = retryScheduler();
+    // The call may schedule another retry, don't let it destroy itself
+    const std::function<void()> call(iCall);
+
+    iActive = true;
+    iCall = std::function<void()>();
+    scheduler->iStats.active++;
+    scheduler->iStats.started++;
+    call();
+}
+
+void QOfonoExtRetry::release()
+{
+    if (iActive) {
+        Scheduler* scheduler = retryScheduler();
+        iActive = false;
+        scheduler->iStats.active--;
+        scheduler->startWaiting();
+    }
+}
+
+void QOfonoExtRetry::finished(bool aSuccess)
+{
+    if (aSuccess) {
+        if (iActive) {
+            retryScheduler()->iStats.succeeded++;
+        }
+        iAttempt = 0;
+    }
+    release();
+}
+
+void QOfonoExtRetry::cancel()
+{
+    Scheduler* scheduler = retryScheduler();
+    bool cancelled = iActive;
+    if (iTimer && iTimer->isActive()) {
+        iTimer->stop();
+        cancelled = true;
+    }
+    if (scheduler->iWaiting.removeOne(this)) {
+        scheduler->iStats.waiting = scheduler->iWaiting.count();
+        cancelled = true;
+    }
+    if (cancelled) {
+        scheduler->iStats.cancelled++;
+    }
+    iCall = std::function<void()>();
+    iAttempt = 0;
+    release();
+}
+
+// ==========================================================================
+// QOfonoExtRetryStats
+// ==========================================================================
+
+QOfonoExtRetryStats QOfonoExtRetryStats::current()
+{
+    return retryScheduler()->iStats;
+}
+
+int QOfonoExtRetryStats::maxActive()
+{
+    return retryScheduler()->iMaxActive;
+}
+
+void QOfonoExtRetryStats::setMaxActive(int aMaxActive)
+{
+    QOfonoExtRetry::Scheduler* scheduler = retryScheduler();
+    scheduler->iMaxActive = qMax(aMaxActive, 1);
+    scheduler->startWaiting();
+}
+
+// ==========================================================================
+// QOfonoExt
+// ==========================================================================
+
 bool QOfonoExt::isTimeout(QDBusError aError)
 {
     switch (aError.type()) {
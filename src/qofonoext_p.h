@@ -17,16 +17,105 @@
 #define QOFONOEXT_PRIVATE_H
 
 #include "qofonoext_types.h"
+#include "qofonoextretrystats.h"
 
 #include <QtDBus>
 
 #define OFONO_SERVICE "org.ofono"
-#define OFONO_BUS QDBusConnection::systemBus()
+#define OFONO_BUS QOfonoExt::bus()
 
 typedef QList<bool> QOfonoExtBoolList;
 
+// Lightweight replacement for QDBusAbstractInterface, which looks up
+// the owner of the service name with a blocking call every time it's
+// constructed. Method calls are simply addressed to the well-known name,
+// and signal subscriptions go through QDBusConnection::connect() which
+// tracks the name owner once per service and shares it between all
+// subscriptions. Signals are disconnected when the proxy is deleted.
+// It's still a QObject so that it can parent the pending call watchers.
+class QOfonoExtProxy : public QObject
+{
+public:
+    QOfonoExtProxy(const QString& aPath, const QString& aInterface, QObject* aParent);
+    ~QOfonoExtProxy();
+
+    QString path() const { return iPath; }
+    QDBusPendingCall asyncCall(const QString& aMethod) const;
+    QDBusMessage call(const QString& aMethod) const;
+    bool connectSignal(const QString& aSignal, QObject* aReceiver, const char* aSlot);
+
+private:
+    struct Subscription {
+        QString iSignal;
+        QPointer<QObject> iReceiver;
+        QByteArray iSlot;
+    };
+
+    const QString iPath;
+    const QString iInterface;
+    QList<Subscription> iSubscriptions;
+};
+
+// Re-issues a timed out D-Bus call after a jittered exponential backoff.
+// All instances share a global cap on the number of retried calls in
+// flight, the ones over the cap wait for a free slot. The owner reports
+// completion of each call with finished(). Deleting the object (or
+// cancel) drops the pending retry and releases the slot. Not thread
+// safe, all users are expected to live on the same thread.
+class QOfonoExtRetry
+{
+public:
+    class Scheduler;
+
+    QOfonoExtRetry();
+    ~QOfonoExtRetry();
+
+    void schedule(std::function<void()> aCall);
+    void finished(bool aSuccess);
+    void cancel();
+
+private:
+    friend class Scheduler;
+    void onTimeout();
+    void start();
+    void release();
+
+private:
+    int iAttempt;
+    bool iActive;
+    QTimer* iTimer;
+    std::function<void()> iCall;
+};
+
 namespace QOfonoExt {
     bool isTimeout(QDBusError aError);
+
+    // System bus unless QOFONOEXT_BUS environment variable says
+    // otherwise. It can be "system", "session" or a D-Bus address.
+    QDBusConnection bus();
+
+    // Invokes the callback once, as soon as aObject->valid() returns
+    // true. The callback is dropped if the context object is destroyed
+    // before that happens.
+    template <class T, typename Signal>
+    void whenValid(T* aObject, Signal aValidChanged, QObject* aContext,
+        std::function<void()> aCallback)
+    {
+        if (aObject->valid()) {
+            aCallback();
+        } else {
+            QSharedPointer<QMetaObject::Connection> connection(new QMetaObject::Connection);
+            *connection = QObject::connect(aObject, aValidChanged,
+                aContext ? aContext : aObject, [aObject, connection, aCallback]() {
+                if (aObject->valid()) {
+                    // Disconnecting destroys the lambda, copy the callback
+                    const std::function<void()> callback(aCallback);
+                    QObject::disconnect(*connection);
+                    callback();
+                }
+            });
+        }
+    }
 }
 
 #endif // QOFONOEXT_PRIVATE_H
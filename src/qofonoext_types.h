@@ -18,6 +18,8 @@
 
 #include <QtCore>
 
+#include <functional>
+
 #ifndef QOFONOEXT_EXPORT
 #  if defined(QOFONOEXT_LIBRARY)
 #    define QOFONOEXT_EXPORT Q_DECL_EXPORT
@@ -15,69 +15,58 @@
 
 #include "qofonoextcell.h"
 #include "qofonoextcellinfo.h"
-#include "qofonoext_p.h"
+#include "qofonoextcelldata_p.h"
 
-namespace {
-    const QString kTypeGsm("gsm");
-    const QString kTypeWcdma("wcdma");
-    const QString kTypeLte("lte");
-    const QString kTypeNr("nr");
+#include <QElapsedTimer>
+#include <QThread>
 
+namespace {
     const QString kMethodGetAll("GetAll");
+    const QString kSignalPropertyChanged("PropertyChanged");
+    const QString kSignalRegisteredChanged("RegisteredChanged");
+    const QString kSignalRemoved("Removed");
 }
 
-#define QOFONOEXT_INVALID_VALUE   ((int)QOfonoExtCell::InvalidValue)
-
-#define CELL_PROPERTIES(p) \
-    p(mcc) p(mnc) p(signalStrength) p(lac) p(cid) p(arfcn) p(bsic) \
-    p(bitErrorRate) p(psc) p(uarfcn) p(ci) p(pci) p(tac) p(earfcn) p(rsrp) \
-    p(rsrq) p(rssnr) p(cqi) p(timingAdvance) p(nrarfcn) \
-    p(ssRsrp) p(ssRsrq) p(ssSinr) p(csiRsrp) p(csiRsrq) p(csiSinr)
-
 // ==========================================================================
-// QOfonoExtCellProxy
+// QOfonoExtCellUpdate
 //
-// qdbusxml2cpp doesn't really do much, and has a number of limitations,
-// such as the limits on number of arguments for QDBusPendingReply template.
-// It's easier to write these proxies by hand.
+// Changes accumulated by the worker thread for one cell
 // ==========================================================================
 
-class QOfonoExtCellProxy: public QDBusAbstractInterface
+struct QOfonoExtCellUpdate
 {
-    Q_OBJECT
+    QOfonoExtCellUpdate() : iChanges(0), iValues(), iRegistered(false), iRemoved(false) {}
 
-public:
-    QOfonoExtCellProxy(const QString &aPath, QObject *aParent)
-        : QDBusAbstractInterface(OFONO_SERVICE, aPath,
-                                 "org.nemomobile.ofono.Cell", OFONO_BUS, aParent) {}
-
-public Q_SLOTS: // METHODS
-    QDBusPendingCall GetAllAsync()
-        { return asyncCall(kMethodGetAll); }
-    QDBusMessage GetAllSync()
-        { return call(kMethodGetAll); }
-
-Q_SIGNALS: // SIGNALS
-    void PropertyChanged(const QString &aName, const QDBusVariant &aValue);
-    void RegisteredChanged(bool aRegistered);
-    void Removed();
+    quint64 iChanges; // Bits of QOfonoExtCell::Property
+    int iValues[QOfonoExtCell::PropertyCount];
+    bool iRegistered;
+    bool iRemoved;
 };
 
+typedef QHash<QString,QOfonoExtCellUpdate> QOfonoExtCellUpdates;
+Q_DECLARE_METATYPE(QOfonoExtCellUpdates)
+
 // ==========================================================================
 // QOfonoExtCell::Private
+//
+// The front end, one per QOfonoExtCell. Everything which has to do with
+// D-Bus is in the Backend, shared by all the cells with the same path.
+// The front end only decides when and how to emit the change signals.
 // ==========================================================================
 
-class QOfonoExtCell::Private : public QOfonoExtCellProxy
+class QOfonoExtCell::Private : public QObject
 {
     Q_OBJECT
 
 public:
-    enum Property {
-        PropertyUnknown = -1,
-        #define Property_(x) Property_##x,
-        CELL_PROPERTIES(Property_)
-        PropertyCount
-    };
+    typedef QOfonoExtCellData::Private Data;
+    typedef Data::GetAllReply GetAllReply;
+
+    class Backend;
+    class Demux;
+    class Receiver;
+
+    static int sWorkerBatchInterval;
 
     struct PropertyDesc {
         QString name;
@@ -87,173 +76,638 @@ public:
 
     static const PropertyDesc Properties[PropertyCount];
 
-    typedef QDBusPendingReply <
-        int,          // 0. version
-        QString,      // 1. type
-        bool,         // 2. registered
-        QVariantMap>  // 3. properties
-        GetAllReply;
+    Private(QOfonoExtCell *aParent);
+    ~Private();
 
-    Private(const QString &aPath, QOfonoExtCell *aParent);
-    void getAllSyncInit();
+    const Data* data() const;
+    QString path() const;
+    void setPath(const QString &aPath, bool aMayBlock, bool aEmitSignals);
+    void setCoalesceInterval(int aMilliseconds);
+    void setSignalInterval(int aMilliseconds);
+    int signalBar(int aSignalLevelDbm) const;
 
     static int valueInt(Private* aThis, Property aProperty);
-    static Type typeFromString(const QString &aType);
-    static Property propertyFromString(const QString &aProperty);
-    static int getRssiDbm(int aSignalStrength);
-    static int inRange(int aValue, int aRangeMin, int aRangeMax);
 
 private:
-    QOfonoExtCell* cell();
-    void getAllAsync();
-    bool pathValid();
-    bool updateSignalLevelDbm();
-    void handleGetAllReply(GetAllReply aReply, bool aEmitSignals);
-    void invalidateValues();
+    void onBackendChanged(quint64 aChanges);
+    void throttleChanges();
+    int notifiedValue(int aProperty) const;
+    int currentValue(int aProperty) const;
+    void emitChanges();
     static void propertyChanged(QOfonoExtCell* aCell, QString aName, int aValue);
 
 public Q_SLOTS:
-    void updateAllAsync();
+    void emitQueuedChanges();
 
 private Q_SLOTS:
-    void onGetAllFinished(QDBusPendingCallWatcher* aWatcher);
+    void emitHeldChanges();
+
+public:
+    static const quint64 SignalChanges;
+    static const QExplicitlySharedDataPointer<Data> sEmptyData;
+
+    QSharedPointer<Backend> iBackend;
+    int iCoalesceInterval;
+    int iSignalInterval;
+    int iSignalThreshold;
+    int iSignalBars;
+
+private:
+    QOfonoExtCell* iParent;
+    QTimer* iChangeTimer;
+    quint64 iPendingChanges;
+    QTimer* iSignalTimer;
+    quint64 iHeldChanges;
+    QElapsedTimer iLastSignalNotification;
+    int iNotifiedValues[PropertyCount];
+    int iNotifiedSignalLevelDbm;
+};
+
+// ==========================================================================
+// QOfonoExtCell::Private::Backend
+//
+// One per object path, shared by all QOfonoExtCell objects pointing to
+// the same cell, so that there's only one proxy, one GetAll call and one
+// Demux entry per path no matter how many cells are watching it.
+// ==========================================================================
+
+class QOfonoExtCell::Private::Backend : public QObject
+{
+    Q_OBJECT
+
+public:
+    Backend(const QString &aPath);
+    ~Backend();
+
+    static QSharedPointer<Backend> instance(const QString &aPath, bool aMayBlock);
+
+    void addFront(Private* aFront);
+    void removeFront(Private* aFront);
+
     void onPropertyChanged(const QString &aName, const QDBusVariant &aValue);
     void onRegisteredChanged(bool aRegistered);
+    void onRemoved();
+    void applyUpdate(const QOfonoExtCellUpdate &aUpdate);
+
+public Q_SLOTS:
+    void updateAllAsync();
+
+private:
+    void getAllSyncInit();
+    void getAllAsync();
+    bool pathValid();
+    bool updateSignalLevelDbm();
+    void handleGetAllReply(GetAllReply aReply, bool aEmitSignals);
+    bool setValue(Property aProperty, int aValue);
+    Data* writableData();
+    void queueChange(Property aProperty);
+    void notifyFronts();
+
+private Q_SLOTS:
+    void onGetAllFinished(QDBusPendingCallWatcher* aWatcher);
 
 public:
-    bool iValid;
-    bool iRegistered;
-    int iProperties[PropertyCount];
-    int iSignalLevelDbm;
-    QOfonoExtCell::Type iType;
-    qint64 iNci;
+    QExplicitlySharedDataPointer<Data> iData;
 
 private:
+    static QHash<QString, QWeakPointer<Backend> > sInstances;
+    QList<Private*> iFronts;
+    QOfonoExtProxy* iProxy; // Signals are received by Demux
     QDBusPendingCallWatcher* iPendingGetAll;
     QSharedPointer<QOfonoExtCellInfo> iCellInfo;
+    QSharedPointer<Demux> iDemux;
+    QOfonoExtRetry iRetry;
+    quint64 iChanges;
 };
 
-void QOfonoExtCell::Private::propertyChanged(QOfonoExtCell* aCell, QString aName, int aValue)
+// ==========================================================================
+// QOfonoExtCell::Private::Receiver
+//
+// Lives on the worker thread (see QOfonoExtCell::setWorkerThreadEnabled),
+// parses the cell signals there and hands them over to the Demux in
+// batches, at most one batch per interval.
+// ==========================================================================
+
+class QOfonoExtCell::Private::Receiver : public QObject
 {
-    Q_EMIT aCell->propertyChanged(aName, aValue);
+    Q_OBJECT
+
+public:
+    Receiver(int aBatchInterval);
+    ~Receiver();
+
+    static bool connectSignals(QObject* aReceiver, const QString &aPath);
+    static void disconnectSignals(QObject* aReceiver, const QString &aPath);
+
+public Q_SLOTS:
+    void subscribe(QString aPath);
+    void unsubscribe(QString aPath);
+
+Q_SIGNALS:
+    void updates(QOfonoExtCellUpdates aUpdates);
+
+private Q_SLOTS:
+    void onPropertyChanged(const QDBusMessage &aMessage);
+    void onRegisteredChanged(const QDBusMessage &aMessage);
+    void onRemoved(const QDBusMessage &aMessage);
+    void flush();
+
+private:
+    void scheduleFlush();
+
+private:
+    QTimer* iTimer;
+    QOfonoExtCellUpdates iUpdates;
+    QSet<QString> iPaths;
+};
+
+QOfonoExtCell::Private::Receiver::Receiver(int aBatchInterval) :
+    iTimer(new QTimer(this))
+{
+    iTimer->setSingleShot(true);
+    iTimer->setInterval(aBatchInterval);
+    connect(iTimer, SIGNAL(timeout()), SLOT(flush()));
 }
 
-const QOfonoExtCell::Private::PropertyDesc QOfonoExtCell::Private::Properties[] = {
-    #define PropertyDesc_(x) {QString(#x), &QOfonoExtCell::x##Changed, propertyChanged},
-    CELL_PROPERTIES(PropertyDesc_)
+QOfonoExtCell::Private::Receiver::~Receiver()
+{
+    QSet<QString>::const_iterator it = iPaths.constBegin();
+    for (; it != iPaths.constEnd(); ++it) {
+        disconnectSignals(this, *it);
+    }
+}
+
+// Empty path subscribes to the signals of all cells
+bool QOfonoExtCell::Private::Receiver::connectSignals(QObject* aReceiver, const QString &aPath)
+{
+    QDBusConnection bus(OFONO_BUS);
+    return bus.connect(OFONO_SERVICE, aPath, OFONO_CELL_INTERFACE,
+            kSignalPropertyChanged, aReceiver,
+            SLOT(onPropertyChanged(QDBusMessage))) &&
+        bus.connect(OFONO_SERVICE, aPath, OFONO_CELL_INTERFACE,
+            kSignalRegisteredChanged, aReceiver,
+            SLOT(onRegisteredChanged(QDBusMessage))) &&
+        bus.connect(OFONO_SERVICE, aPath, OFONO_CELL_INTERFACE,
+            kSignalRemoved, aReceiver,
+            SLOT(onRemoved(QDBusMessage)));
+}
+
+void QOfonoExtCell::Private::Receiver::disconnectSignals(QObject* aReceiver, const QString &aPath)
+{
+    QDBusConnection bus(OFONO_BUS);
+    bus.disconnect(OFONO_SERVICE, aPath, OFONO_CELL_INTERFACE,
+        kSignalPropertyChanged, aReceiver,
+        SLOT(onPropertyChanged(QDBusMessage)));
+    bus.disconnect(OFONO_SERVICE, aPath, OFONO_CELL_INTERFACE,
+        kSignalRegisteredChanged, aReceiver,
+        SLOT(onRegisteredChanged(QDBusMessage)));
+    bus.disconnect(OFONO_SERVICE, aPath, OFONO_CELL_INTERFACE,
+        kSignalRemoved, aReceiver,
+        SLOT(onRemoved(QDBusMessage)));
+}
+
+void QOfonoExtCell::Private::Receiver::subscribe(QString aPath)
+{
+    // Invoked on the worker thread
+    if (connectSignals(this, aPath)) {
+        iPaths.insert(aPath);
+    }
+}
+
+void QOfonoExtCell::Private::Receiver::unsubscribe(QString aPath)
+{
+    // Invoked on the worker thread
+    if (iPaths.remove(aPath)) {
+        disconnectSignals(this, aPath);
+    }
+}
+
+void QOfonoExtCell::Private::Receiver::scheduleFlush()
+{
+    if (!iTimer->isActive()) {
+        iTimer->start();
+    }
+}
+
+void QOfonoExtCell::Private::Receiver::flush()
+{
+    QOfonoExtCellUpdates updates;
+    updates.swap(iUpdates);
+    Q_EMIT this->updates(updates);
+}
+
+void QOfonoExtCell::Private::Receiver::onPropertyChanged(const QDBusMessage &aMessage)
+{
+    const QList<QVariant> args(aMessage.arguments());
+    if (args.count() == 2) {
+        int value;
+        const Property p = Data::propertyFromString(args.at(0).toString());
+        if (p != PropertyUnknown &&
+            Data::intValue(qvariant_cast<QDBusVariant>(args.at(1)).variant(), &value)) {
+            // Only the last value survives
+            QOfonoExtCellUpdate& update = iUpdates[aMessage.path()];
+            update.iValues[p] = value;
+            update.iChanges |= (Q_UINT64_C(1) << p);
+            scheduleFlush();
+        }
+    }
+}
+
+void QOfonoExtCell::Private::Receiver::onRegisteredChanged(const QDBusMessage &aMessage)
+{
+    const QList<QVariant> args(aMessage.arguments());
+    if (args.count() == 1) {
+        QOfonoExtCellUpdate& update = iUpdates[aMessage.path()];
+        update.iRegistered = args.at(0).toBool();
+        update.iChanges |= (Q_UINT64_C(1) << PropertyRegistered);
+        scheduleFlush();
+    }
+}
+
+void QOfonoExtCell::Private::Receiver::onRemoved(const QDBusMessage &aMessage)
+{
+    iUpdates[aMessage.path()].iRemoved = true;
+    scheduleFlush();
+}
+
+// ==========================================================================
+// QOfonoExtCell::Private::Demux
+//
+// Receives PropertyChanged, RegisteredChanged and Removed signals for all
+// cells and dispatches them to the backends by object path. Optionally,
+// the signals are received by the Receiver on a worker thread and arrive
+// here in batches.
+//
+// While only a few cells are being watched, each of them gets its own
+// match rules, so that a client watching just the serving cell doesn't
+// wake up for every neighbour cell update. Past MaxPathSubscriptions
+// cells a single path-less rule per signal replaces them, which keeps
+// the number of match rules in the bus daemon constant, at the cost of
+// receiving the signals of the unwatched cells too. With that many cells
+// it's usually QOfonoExtCellWatcher watching all of them anyway. QtDBus
+// can't express a match rule for "the cells of this modem only".
+// ==========================================================================
+
+class QOfonoExtCell::Private::Demux : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum {
+        MaxPathSubscriptions = 8,
+        MinPathSubscriptions = 4 // Hysteresis
+    };
+
+    Demux();
+    ~Demux();
+
+    static QSharedPointer<Demux> instance();
+    static bool exists() { return !sSharedInstance.isNull(); }
+
+    void add(const QString &aPath, Backend* aBackend, QOfonoExtCellInfo* aCellInfo);
+    void remove(const QString &aPath, Backend* aBackend);
+
+private Q_SLOTS:
+    void onPropertyChanged(const QDBusMessage &aMessage);
+    void onRegisteredChanged(const QDBusMessage &aMessage);
+    void onRemoved(const QDBusMessage &aMessage);
+    void onUpdates(QOfonoExtCellUpdates aUpdates);
+    void onCellsAddedOrRemoved(QStringList aPaths);
+
+private:
+    void subscribe(const QString &aPath);
+    void unsubscribe(const QString &aPath);
+
+private:
+    static QWeakPointer<Demux> sSharedInstance;
+    QHash<QString, Backend*> iBackends;
+    QSet<QString> iSubscriptions; // Empty path means all cells
+    bool iAllPaths;
+    QThread* iThread;
+    Receiver* iReceiver;
 };
 
-QOfonoExtCell::Private::Private(const QString &aPath, QOfonoExtCell *aParent) :
-    QOfonoExtCellProxy(aPath, aParent),
-    iValid(false),
-    iRegistered(false),
-    iSignalLevelDbm(QOFONOEXT_INVALID_VALUE),
-    iType(UNKNOWN),
-    iNci(INT64_MAX),
-    iPendingGetAll(Q_NULLPTR)
+QWeakPointer<QOfonoExtCell::Private::Demux> QOfonoExtCell::Private::Demux::sSharedInstance;
+
+// Negative interval means that the worker thread is disabled
+int QOfonoExtCell::Private::sWorkerBatchInterval = -1;
+
+QOfonoExtCell::Private::Demux::Demux() :
+    iAllPaths(false),
+    iThread(Q_NULLPTR),
+    iReceiver(Q_NULLPTR)
+{
+    if (sWorkerBatchInterval >= 0) {
+        qRegisterMetaType<QOfonoExtCellUpdates>("QOfonoExtCellUpdates");
+        iReceiver = new Receiver(sWorkerBatchInterval);
+        iThread = new QThread(this);
+        iReceiver->moveToThread(iThread);
+        connect(iThread, SIGNAL(finished()), iReceiver, SLOT(deleteLater()));
+        connect(iReceiver, SIGNAL(updates(QOfonoExtCellUpdates)),
+            SLOT(onUpdates(QOfonoExtCellUpdates)));
+        iThread->start();
+    }
+}
+
+QOfonoExtCell::Private::Demux::~Demux()
+{
+    if (iThread) {
+        // The receiver drops its own subscriptions
+        iThread->quit();
+        iThread->wait();
+    } else {
+        QSet<QString>::const_iterator it = iSubscriptions.constBegin();
+        for (; it != iSubscriptions.constEnd(); ++it) {
+            Receiver::disconnectSignals(this, *it);
+        }
+    }
+}
+
+QSharedPointer<QOfonoExtCell::Private::Demux> QOfonoExtCell::Private::Demux::instance()
 {
+    QSharedPointer<Demux> instance = sSharedInstance;
+    if (instance.isNull()) {
+        instance = QSharedPointer<Demux>(new Demux, &QObject::deleteLater);
+        sSharedInstance = instance;
+    }
+    return instance;
+}
+
+void QOfonoExtCell::Private::Demux::subscribe(const QString &aPath)
+{
+    if (iReceiver) {
+        iSubscriptions.insert(aPath);
+        QMetaObject::invokeMethod(iReceiver, "subscribe",
+            Qt::QueuedConnection, Q_ARG(QString, aPath));
+    } else if (Receiver::connectSignals(this, aPath)) {
+        iSubscriptions.insert(aPath);
+    }
+}
+
+void QOfonoExtCell::Private::Demux::unsubscribe(const QString &aPath)
+{
+    if (iSubscriptions.remove(aPath)) {
+        if (iReceiver) {
+            QMetaObject::invokeMethod(iReceiver, "unsubscribe",
+                Qt::QueuedConnection, Q_ARG(QString, aPath));
+        } else {
+            Receiver::disconnectSignals(this, aPath);
+        }
+    }
+}
+
+void QOfonoExtCell::Private::Demux::add(const QString &aPath, Backend* aBackend, QOfonoExtCellInfo* aCellInfo)
+{
+    const bool newPath = !iBackends.contains(aPath);
+
+    iBackends.insert(aPath, aBackend);
+    if (newPath && !iAllPaths) {
+        if (iBackends.count() > MaxPathSubscriptions) {
+            // The new rules are added before the old ones are removed,
+            // so nothing gets lost in between. A signal may be delivered
+            // twice during the switch, which doesn't change the values.
+            const QList<QString> paths(iSubscriptions.values());
+            iAllPaths = true;
+            subscribe(QString());
+            for (int i=0; i<paths.count(); i++) {
+                unsubscribe(paths.at(i));
+            }
+        } else {
+            subscribe(aPath);
+        }
+    }
+
+    // Only the cells which have been added or removed get notified
+    connect(aCellInfo, SIGNAL(cellsAdded(QStringList)),
+        SLOT(onCellsAddedOrRemoved(QStringList)), Qt::UniqueConnection);
+    connect(aCellInfo, SIGNAL(cellsRemoved(QStringList)),
+        SLOT(onCellsAddedOrRemoved(QStringList)), Qt::UniqueConnection);
+}
+
+void QOfonoExtCell::Private::Demux::remove(const QString &aPath, Backend* aBackend)
+{
+    // The path may already be served by a new backend
+    QHash<QString, Backend*>::iterator it = iBackends.find(aPath);
+    if (it != iBackends.end() && it.value() == aBackend) {
+        iBackends.erase(it);
+        if (!iAllPaths) {
+            unsubscribe(aPath);
+        } else if (iBackends.count() <= MinPathSubscriptions) {
+            const QList<QString> paths(iBackends.keys());
+            iAllPaths = false;
+            for (int i=0; i<paths.count(); i++) {
+                subscribe(paths.at(i));
+            }
+            unsubscribe(QString());
+        }
+    }
+}
+
+void QOfonoExtCell::Private::Demux::onPropertyChanged(const QDBusMessage &aMessage)
+{
+    const QList<QVariant> args(aMessage.arguments());
+    if (args.count() == 2) {
+        Backend* backend = iBackends.value(aMessage.path());
+        if (backend) {
+            backend->onPropertyChanged(args.at(0).toString(),
+                qvariant_cast<QDBusVariant>(args.at(1)));
+        }
+    }
+}
+
+void QOfonoExtCell::Private::Demux::onRegisteredChanged(const QDBusMessage &aMessage)
+{
+    const QList<QVariant> args(aMessage.arguments());
+    if (args.count() == 1) {
+        Backend* backend = iBackends.value(aMessage.path());
+        if (backend) {
+            backend->onRegisteredChanged(args.at(0).toBool());
+        }
+    }
+}
+
+void QOfonoExtCell::Private::Demux::onRemoved(const QDBusMessage &aMessage)
+{
+    Backend* backend = iBackends.value(aMessage.path());
+    if (backend) {
+        backend->onRemoved();
+    }
+}
+
+void QOfonoExtCell::Private::Demux::onUpdates(QOfonoExtCellUpdates aUpdates)
+{
+    QOfonoExtCellUpdates::const_iterator it = aUpdates.constBegin();
+    for (; it != aUpdates.constEnd(); ++it) {
+        // Signal handlers may release the backend, hence the lookup
+        // inside the loop. Backends are deleted with deleteLater()
+        Backend* backend = iBackends.value(it.key());
+        if (backend) {
+            const QOfonoExtCellUpdate& update = it.value();
+            backend->applyUpdate(update);
+            if (update.iRemoved) {
+                backend->onRemoved();
+            }
+        }
+    }
+}
+
+void QOfonoExtCell::Private::Demux::onCellsAddedOrRemoved(QStringList aPaths)
+{
+    for (int i=0; i<aPaths.count(); i++) {
+        Backend* backend = iBackends.value(aPaths.at(i));
+        if (backend) {
+            backend->updateAllAsync();
+        }
+    }
+}
+
+// ==========================================================================
+// QOfonoExtCell::Private::Backend implementation
+// ==========================================================================
+
+QHash<QString, QWeakPointer<QOfonoExtCell::Private::Backend> > QOfonoExtCell::Private::Backend::sInstances;
+
+QOfonoExtCell::Private::Backend::Backend(const QString &aPath) :
+    iData(new Data(aPath)),
+    iProxy(new QOfonoExtProxy(aPath, OFONO_CELL_INTERFACE, this)),
+    iPendingGetAll(Q_NULLPTR),
     // Extract modem path from the cell path, e.g. "/ril_0/cell_0" => "/ril_0"
-    iCellInfo = QOfonoExtCellInfo::instance(aPath.left(aPath.lastIndexOf('/')));
-    invalidateValues();
-    connect(this, SIGNAL(Removed()),
-        aParent, SIGNAL(removed()));
-    connect(this,
-        SIGNAL(PropertyChanged(QString,QDBusVariant)),
-        SLOT(onPropertyChanged(QString,QDBusVariant)));
-    connect(this,
-        SIGNAL(RegisteredChanged(bool)),
-        SLOT(onRegisteredChanged(bool)));
-    connect(iCellInfo.data(),
-        SIGNAL(cellsChanged()),
-        SLOT(updateAllAsync()));
+    iCellInfo(QOfonoExtCellInfo::instance(aPath.left(aPath.lastIndexOf('/')))),
+    iDemux(Demux::instance()),
+    iChanges(0)
+{
+    iDemux->add(aPath, this, iCellInfo.data());
     connect(iCellInfo.data(),
         SIGNAL(validChanged()),
         SLOT(updateAllAsync()));
 }
 
-inline QOfonoExtCell* QOfonoExtCell::Private::cell()
+QOfonoExtCell::Private::Backend::~Backend()
 {
-    return qobject_cast<QOfonoExtCell*>(parent());
+    // Leave the entry alone if it has already been replaced
+    const QString path(iData->iPath);
+    iDemux->remove(path, this);
+    QHash<QString, QWeakPointer<Backend> >::iterator it = sInstances.find(path);
+    if (it != sInstances.end() && it.value().isNull()) {
+        sInstances.erase(it);
+    }
 }
 
-QOfonoExtCell::Type QOfonoExtCell::Private::typeFromString(const QString &aType)
+QSharedPointer<QOfonoExtCell::Private::Backend> QOfonoExtCell::Private::Backend::instance(const QString &aPath, bool aMayBlock)
 {
-    return (aType == kTypeGsm) ? GSM :
-           (aType == kTypeLte) ? LTE :
-           (aType == kTypeWcdma) ? WCDMA :
-           (aType == kTypeNr) ? NR :
-           UNKNOWN;
+    QSharedPointer<Backend> backend = sInstances.value(aPath);
+    if (backend.isNull()) {
+        // The expired entry (if any) gets replaced. The old backend may
+        // still be waiting for deleteLater(), it won't touch the new one.
+        backend = QSharedPointer<Backend>(new Backend(aPath), &QObject::deleteLater);
+        sInstances.insert(aPath, backend);
+        if (aMayBlock) {
+            backend->getAllSyncInit();
+        } else {
+            backend->updateAllAsync();
+        }
+    }
+    return backend;
 }
 
-QOfonoExtCell::Private::Property QOfonoExtCell::Private::propertyFromString(const QString &aProperty)
+void QOfonoExtCell::Private::Backend::addFront(Private* aFront)
 {
-    for (int i=PropertyUnknown+1; i<PropertyCount; i++) {
-        if (Properties[i].name == aProperty) {
-            return (Property)i;
+    iFronts.append(aFront);
+}
+
+void QOfonoExtCell::Private::Backend::removeFront(Private* aFront)
+{
+    iFronts.removeOne(aFront);
+}
+
+void QOfonoExtCell::Private::Backend::notifyFronts()
+{
+    const quint64 changes = iChanges;
+    if (changes) {
+        // Signal handlers may delete the fronts
+        QList<QPointer<Private> > fronts;
+        for (int i=0; i<iFronts.count(); i++) {
+            fronts.append(QPointer<Private>(iFronts.at(i)));
+        }
+        iChanges = 0;
+        for (int i=0; i<fronts.count(); i++) {
+            if (fronts.at(i)) {
+                fronts.at(i)->onBackendChanged(changes);
+            }
+        }
+    }
+}
+
+void QOfonoExtCell::Private::Backend::onRemoved()
+{
+    QList<QPointer<Private> > fronts;
+    for (int i=0; i<iFronts.count(); i++) {
+        fronts.append(QPointer<Private>(iFronts.at(i)));
+    }
+    for (int i=0; i<fronts.count(); i++) {
+        if (fronts.at(i)) {
+            Q_EMIT fronts.at(i)->iParent->removed();
         }
     }
-    return PropertyUnknown;
 }
 
-int QOfonoExtCell::Private::valueInt(Private* aThis, QOfonoExtCell::Private::Property aProperty)
+inline QOfonoExtCellData::Private* QOfonoExtCell::Private::Backend::writableData()
 {
-    return aThis ? aThis->iProperties[aProperty] : QOFONOEXT_INVALID_VALUE;
+    // Copy the data if someone is holding a QOfonoExtCellData snapshot
+    iData.detach();
+    return iData.data();
 }
 
-bool QOfonoExtCell::Private::pathValid()
+inline void QOfonoExtCell::Private::Backend::queueChange(Property aProperty)
 {
-    return iCellInfo->valid() && iCellInfo->cells().contains(path());
+    iChanges |= (Q_UINT64_C(1) << aProperty);
 }
 
-void QOfonoExtCell::Private::updateAllAsync()
+bool QOfonoExtCell::Private::Backend::pathValid()
+{
+    return iCellInfo->valid() && iCellInfo->containsCell(iData->iPath);
+}
+
+void QOfonoExtCell::Private::Backend::updateAllAsync()
 {
     if (pathValid()) {
-        if (!iValid && !iPendingGetAll) {
+        if (!iData->iValid && !iPendingGetAll) {
             getAllAsync();
         }
     } else {
         delete iPendingGetAll;
         iPendingGetAll = Q_NULLPTR;
+        iRetry.cancel();
 
-        if (iValid) {
-            iValid = false;
-            Q_EMIT cell()->validChanged();
+        if (iData->iValid) {
+            writableData()->iValid = false;
+            queueChange(PropertyValid);
+            notifyFronts();
         }
     }
 }
 
-int QOfonoExtCell::Private::getRssiDbm(int aValue)
-{
-    // Range for RSSI in ASU (0-31, 99) as defined in TS 27.007 8.69
-    return (aValue < 0 || aValue > 31) ? QOFONOEXT_INVALID_VALUE : (-113 + (2 * aValue));
-}
-
-int QOfonoExtCell::Private::inRange(int aValue, int aMin, int aMax)
-{
-    return (aValue < aMin || aValue > aMax) ? QOFONOEXT_INVALID_VALUE : aValue;
-}
-
-void QOfonoExtCell::Private::getAllSyncInit()
+void QOfonoExtCell::Private::Backend::getAllSyncInit()
 {
     delete iPendingGetAll;
     iPendingGetAll = NULL;
 
-    GetAllReply reply(GetAllSync());
+    GetAllReply reply(iProxy->call(kMethodGetAll));
     if (!reply.isError()) {
         handleGetAllReply(reply, false);
     }
 }
 
-void QOfonoExtCell::Private::getAllAsync()
+void QOfonoExtCell::Private::Backend::getAllAsync()
 {
     delete iPendingGetAll;
-    iPendingGetAll = new QDBusPendingCallWatcher(GetAllAsync(), this);
+    iPendingGetAll = new QDBusPendingCallWatcher(iProxy->asyncCall(kMethodGetAll), this);
     connect(iPendingGetAll,
         SIGNAL(finished(QDBusPendingCallWatcher*)),
         SLOT(onGetAllFinished(QDBusPendingCallWatcher*)));
 }
 
-void QOfonoExtCell::Private::onGetAllFinished(QDBusPendingCallWatcher* aWatcher)
+void QOfonoExtCell::Private::Backend::onGetAllFinished(QDBusPendingCallWatcher* aWatcher)
 {
     iPendingGetAll = Q_NULLPTR;
     if (aWatcher->isError()) {
@@ -261,156 +715,424 @@ void QOfonoExtCell::Private::onGetAllFinished(QDBusPendingCallWatcher* aWatcher)
         QDBusError error(aWatcher->error());
         qWarning() << error;
         if (QOfonoExt::isTimeout(error)) {
-            getAllAsync();
+            iRetry.schedule([this]() { getAllAsync(); });
+        } else {
+            iRetry.finished(false);
         }
     } else {
+        iRetry.finished(true);
         handleGetAllReply(*aWatcher, true);
     }
     aWatcher->deleteLater();
 }
 
-void QOfonoExtCell::Private::handleGetAllReply(GetAllReply aReply, bool aEmitSignals)
+void QOfonoExtCell::Private::Backend::handleGetAllReply(GetAllReply aReply, bool aEmitSignals)
 {
-    const Type prevType = iType;
-    const bool wasRegistered = iRegistered;
-    const int prevSignalLevelDbm = iSignalLevelDbm;
-    const qint64 prevNci = iNci;
+    // Replace the data rather than modifying it, the old one is needed
+    // for comparison and may be shared with QOfonoExtCellData anyway
+    const QExplicitlySharedDataPointer<Data> prev(iData);
+    Data* data = new Data(prev->iPath);
 
-    // Ignore argumentAt<0> version
-    iType = typeFromString(aReply.argumentAt<1>());
-    iRegistered = aReply.argumentAt<2>();
-    const QVariantMap variants(aReply.argumentAt<3>());
+    data->setGetAllReply(aReply);
+    iData = data;
 
-    // Unpack properties (they are all integers)
-    int prevProps[PropertyCount];
-    memcpy(prevProps, iProperties, sizeof(iProperties));
+    // Emit signals
+    if (aEmitSignals) {
+        for (int i=0; i<PropertyCount; i++) {
+            if (data->iProperties[i] != prev->iProperties[i]) {
+                queueChange((Property)i);
+            }
+        }
+        if (prev->iNci != data->iNci) {
+            queueChange(PropertyNci);
+        }
+        if (prev->iType != data->iType) {
+            queueChange(PropertyType);
+        }
+        if (prev->iRegistered != data->iRegistered) {
+            queueChange(PropertyRegistered);
+        }
+        if (prev->iSignalLevelDbm != data->iSignalLevelDbm) {
+            queueChange(PropertySignalLevelDbm);
+        }
+        if (!prev->iValid) {
+            queueChange(PropertyValid);
+        }
+        notifyFronts();
+    } else {
+        data->iValid = prev->iValid;
+    }
+}
 
-    invalidateValues();
-    for (QVariantMap::ConstIterator it = variants.constBegin();
-         it != variants.constEnd(); it++) {
-        const QString key(it.key());
-        const QVariant value(it.value());
+// Queues the change but doesn't notify anyone. Returns true if the
+// value affects signalLevelDbm.
+bool QOfonoExtCell::Private::Backend::setValue(Property aProperty, int aValue)
+{
+    if (iData->iProperties[aProperty] != aValue) {
+        writableData()->iProperties[aProperty] = aValue;
+        queueChange(aProperty);
+        switch (aProperty) {
+        case PropertySignalStrength:
+        case PropertyRsrp:
+        case PropertySsRsrp:
+            return true;
+        default:
+            break;
+        }
+    }
+    return false;
+}
 
-        if (key == QLatin1String("nci")) {
-            bool ok = false;
-            qint64 int64Value = value.toLongLong(&ok);
-            if (ok) {
-                iNci = int64Value;
-            }
-        } else {
-            bool ok = false;
-            int intValue = value.toInt(&ok);
-            if (ok) {
-                Property p = propertyFromString(key);
-                if (p != PropertyUnknown) {
-                    iProperties[p] = intValue;
-                }
+void QOfonoExtCell::Private::Backend::onPropertyChanged(const QString &aName, const QDBusVariant &aValue)
+{
+    int intValue;
+    if (Data::intValue(aValue.variant(), &intValue)) {
+        Property p = Data::propertyFromString(aName);
+        if (p != PropertyUnknown) {
+            if (setValue(p, intValue) && updateSignalLevelDbm()) {
+                queueChange(PropertySignalLevelDbm);
             }
+            notifyFronts();
         }
     }
+}
 
-    // This one is a combination of other properties, updated separately
-    updateSignalLevelDbm();
+void QOfonoExtCell::Private::Backend::onRegisteredChanged(bool aRegistered)
+{
+    if (iData->iRegistered != aRegistered) {
+        writableData()->iRegistered = aRegistered;
+        queueChange(PropertyRegistered);
+        notifyFronts();
+    }
+}
+
+// Applies a batch of changes received by the worker thread
+void QOfonoExtCell::Private::Backend::applyUpdate(const QOfonoExtCellUpdate &aUpdate)
+{
+    bool dbm = false;
+    for (int i = 0; i < PropertyCount; i++) {
+        if (aUpdate.iChanges & (Q_UINT64_C(1) << i)) {
+            dbm |= setValue((Property)i, aUpdate.iValues[i]);
+        }
+    }
+    if (dbm && updateSignalLevelDbm()) {
+        queueChange(PropertySignalLevelDbm);
+    }
+    if ((aUpdate.iChanges & (Q_UINT64_C(1) << PropertyRegistered)) &&
+        iData->iRegistered != aUpdate.iRegistered) {
+        writableData()->iRegistered = aUpdate.iRegistered;
+        queueChange(PropertyRegistered);
+    }
+    notifyFronts();
+}
+
+bool QOfonoExtCell::Private::Backend::updateSignalLevelDbm()
+{
+    const int signalLevelDbm = Data::signalLevelDbm(iData->iType, iData->iProperties);
+
+    if (iData->iSignalLevelDbm != signalLevelDbm) {
+        writableData()->iSignalLevelDbm = signalLevelDbm;
+        return true;
+    }
+    return false;
+}
+
+// ==========================================================================
+// QOfonoExtCell::Private implementation
+// ==========================================================================
+
+void QOfonoExtCell::Private::propertyChanged(QOfonoExtCell* aCell, QString aName, int aValue)
+{
+    Q_EMIT aCell->propertyChanged(aName, aValue);
+}
+
+const QOfonoExtCell::Private::PropertyDesc QOfonoExtCell::Private::Properties[] = {
+    #define PropertyDesc_(x,X) {QString(#x), &QOfonoExtCell::x##Changed, propertyChanged},
+    CELL_PROPERTIES(PropertyDesc_)
+};
+
+#define SignalChange_(x) (Q_UINT64_C(1) << QOfonoExtCell::Property##x)
+const quint64 QOfonoExtCell::Private::SignalChanges =
+    SignalChange_(SignalStrength) | SignalChange_(BitErrorRate) |
+    SignalChange_(Rsrp) | SignalChange_(Rsrq) | SignalChange_(Rssnr) |
+    SignalChange_(Cqi) | SignalChange_(SsRsrp) | SignalChange_(SsRsrq) |
+    SignalChange_(SsSinr) | SignalChange_(CsiRsrp) | SignalChange_(CsiRsrq) |
+    SignalChange_(CsiSinr) | SignalChange_(SignalLevelDbm);
+#undef SignalChange_
+
+const QExplicitlySharedDataPointer<QOfonoExtCellData::Private> QOfonoExtCell::Private::sEmptyData(new Data);
+
+QOfonoExtCell::Private::Private(QOfonoExtCell *aParent) :
+    QObject(aParent),
+    iCoalesceInterval(-1),
+    iSignalInterval(0),
+    iSignalThreshold(0),
+    iSignalBars(0),
+    iParent(aParent),
+    iChangeTimer(Q_NULLPTR),
+    iPendingChanges(0),
+    iSignalTimer(Q_NULLPTR),
+    iHeldChanges(0),
+    iNotifiedSignalLevelDbm(InvalidValue)
+{
+    for (int i=0; i<PropertyCount; i++) {
+        iNotifiedValues[i] = InvalidValue;
+    }
+}
+
+QOfonoExtCell::Private::~Private()
+{
+    if (iBackend) {
+        iBackend->removeFront(this);
+    }
+}
+
+inline const QOfonoExtCellData::Private* QOfonoExtCell::Private::data() const
+{
+    return iBackend ? iBackend->iData.data() : sEmptyData.data();
+}
+
+QString QOfonoExtCell::Private::path() const
+{
+    return data()->iPath;
+}
+
+// Switches to the backend for the new path. The backend may already have
+// the values, if another cell is looking at the same path.
+void QOfonoExtCell::Private::setPath(const QString &aPath, bool aMayBlock, bool aEmitSignals)
+{
+    const QExplicitlySharedDataPointer<Data> prev(const_cast<Data*>(data()));
+
+    iPendingChanges = 0;
+    iHeldChanges = 0;
+    if (iChangeTimer) {
+        iChangeTimer->stop();
+    }
+    if (iSignalTimer) {
+        iSignalTimer->stop();
+    }
+    iLastSignalNotification.invalidate();
+    if (iBackend) {
+        iBackend->removeFront(this);
+        iBackend.clear();
+    }
+
+    if (!aPath.isEmpty()) {
+        iBackend = Backend::instance(aPath, aMayBlock);
+        iBackend->addFront(this);
+    }
 
-    // Emit signals
     if (aEmitSignals) {
-        QOfonoExtCell* parent = cell();
+        const Data* current = data();
         for (int i=0; i<PropertyCount; i++) {
-            if (iProperties[i] != prevProps[i]) {
-                (parent->*(Properties[i].signal))();
-                Properties[i].propertyChanged(parent, Properties[i].name, iProperties[i]);
+            if (current->iProperties[i] != prev->iProperties[i]) {
+                iPendingChanges |= (Q_UINT64_C(1) << i);
             }
         }
-
-        if (prevNci != iNci) {
-            Q_EMIT parent->nciChanged();
+        if (current->iNci != prev->iNci) {
+            iPendingChanges |= (Q_UINT64_C(1) << PropertyNci);
         }
-
-        iValid = true;
-        if (prevType != iType) {
-            Q_EMIT parent->typeChanged();
+        if (current->iType != prev->iType) {
+            iPendingChanges |= (Q_UINT64_C(1) << PropertyType);
+        }
+        if (current->iRegistered != prev->iRegistered) {
+            iPendingChanges |= (Q_UINT64_C(1) << PropertyRegistered);
         }
-        if (wasRegistered != iRegistered) {
-            Q_EMIT parent->registeredChanged();
+        if (current->iSignalLevelDbm != prev->iSignalLevelDbm) {
+            iPendingChanges |= (Q_UINT64_C(1) << PropertySignalLevelDbm);
         }
-        if (prevSignalLevelDbm != iSignalLevelDbm) {
-            Q_EMIT parent->signalLevelDbmChanged();
+        if (current->iValid != prev->iValid) {
+            iPendingChanges |= (Q_UINT64_C(1) << PropertyValid);
         }
-        Q_EMIT parent->signalLevelDbmChanged();
-        Q_EMIT parent->validChanged();
+        emitQueuedChanges();
     }
 }
 
-void QOfonoExtCell::Private::invalidateValues()
+int QOfonoExtCell::Private::valueInt(Private* aThis, QOfonoExtCell::Property aProperty)
+{
+    return aThis ? aThis->data()->iProperties[aProperty] : QOFONOEXT_INVALID_VALUE;
+}
+
+void QOfonoExtCell::Private::onBackendChanged(quint64 aChanges)
+{
+    iPendingChanges |= aChanges;
+    emitChanges();
+}
+
+int QOfonoExtCell::Private::currentValue(int aProperty) const
+{
+    return (aProperty == PropertySignalLevelDbm) ? data()->iSignalLevelDbm :
+        data()->iProperties[aProperty];
+}
+
+int QOfonoExtCell::Private::notifiedValue(int aProperty) const
+{
+    return (aProperty == PropertySignalLevelDbm) ? iNotifiedSignalLevelDbm :
+        iNotifiedValues[aProperty];
+}
+
+int QOfonoExtCell::Private::signalBar(int aSignalLevelDbm) const
 {
-    #define _Init(x) iProperties[Property_##x] = QOFONOEXT_INVALID_VALUE;
-    CELL_PROPERTIES(_Init)
-    iNci = INT64_MAX;
+    // signalLevelDbm is within [-140, -44] range
+    return (iSignalBars <= 0 || aSignalLevelDbm == InvalidValue) ? 0 :
+        (1 + qMin(iSignalBars - 1, (aSignalLevelDbm + 140) * iSignalBars / 97));
 }
 
-void QOfonoExtCell::Private::onPropertyChanged(const QString &aName, const QDBusVariant &aValue)
+// Drops the insignificant signal quality changes and holds back the ones
+// arriving within signalInterval from the last notification
+void QOfonoExtCell::Private::throttleChanges()
 {
-    bool ok = false;
-    int intValue = aValue.variant().toInt(&ok);
-    if (ok) {
-        Property p = propertyFromString(aName);
-        if (p != PropertyUnknown && iProperties[p] != intValue) {
-            QOfonoExtCell* parent = cell();
-            iProperties[p] = intValue;
-            Q_EMIT (parent->*(Properties[p].signal))();
-            Q_EMIT parent->propertyChanged(aName, intValue);
-            switch (p) {
-            case Property_signalStrength:
-            case Property_rsrp:
-                if (updateSignalLevelDbm()) {
-                    Q_EMIT parent->signalLevelDbmChanged();
+    quint64 changes = iPendingChanges & SignalChanges;
+
+    if (!changes || (iPendingChanges & (Q_UINT64_C(1) << PropertyValid))) {
+        // Never hold back the initial values
+        return;
+    }
+
+    if (iSignalBars > 0) {
+        if (signalBar(data()->iSignalLevelDbm) != signalBar(iNotifiedSignalLevelDbm)) {
+            // Report everything that has changed since the last report
+            for (int i=0; i<=PropertySignalLevelDbm; i++) {
+                const quint64 bit = (Q_UINT64_C(1) << i);
+                if ((SignalChanges & bit) && currentValue(i) != notifiedValue(i)) {
+                    changes |= bit;
                 }
-                break;
-            case Property_ssRsrp:
-                if (updateSignalLevelDbm()) {
-                    Q_EMIT parent->signalLevelDbmChanged();
+            }
+        } else {
+            changes = 0;
+        }
+    } else if (iSignalThreshold > 0) {
+        for (int i=0; i<=PropertySignalLevelDbm; i++) {
+            const quint64 bit = (Q_UINT64_C(1) << i);
+            if (changes & bit) {
+                const int value = currentValue(i);
+                const int prev = notifiedValue(i);
+                if (value != InvalidValue && prev != InvalidValue &&
+                    qAbs(value - prev) < iSignalThreshold) {
+                    changes &= ~bit;
                 }
-                break;
-            default:
-                break;
             }
         }
     }
+
+    iPendingChanges &= ~SignalChanges;
+    if (changes) {
+        if (iSignalInterval > 0 && iLastSignalNotification.isValid() &&
+            !iLastSignalNotification.hasExpired(iSignalInterval)) {
+            iHeldChanges |= changes;
+            if (!iSignalTimer) {
+                iSignalTimer = new QTimer(this);
+                iSignalTimer->setSingleShot(true);
+                connect(iSignalTimer, SIGNAL(timeout()), SLOT(emitHeldChanges()));
+            }
+            if (!iSignalTimer->isActive()) {
+                iSignalTimer->start(qMax(iSignalInterval -
+                    (int)iLastSignalNotification.elapsed(), 0));
+            }
+        } else {
+            iPendingChanges |= changes;
+        }
+    }
 }
 
-void QOfonoExtCell::Private::onRegisteredChanged(bool aRegistered)
+void QOfonoExtCell::Private::emitHeldChanges()
 {
-    iRegistered = aRegistered;
-    Q_EMIT cell()->registeredChanged();
+    iPendingChanges |= iHeldChanges;
+    iHeldChanges = 0;
+    emitChanges();
 }
 
-bool QOfonoExtCell::Private::updateSignalLevelDbm()
+void QOfonoExtCell::Private::emitChanges()
 {
-    int signalLevelDbm = QOFONOEXT_INVALID_VALUE;
+    throttleChanges();
+    if (iPendingChanges) {
+        if (iCoalesceInterval < 0) {
+            emitQueuedChanges();
+        } else {
+            if (!iChangeTimer) {
+                iChangeTimer = new QTimer(this);
+                iChangeTimer->setSingleShot(true);
+                connect(iChangeTimer, SIGNAL(timeout()), SLOT(emitQueuedChanges()));
+            }
+            if (!iChangeTimer->isActive()) {
+                iChangeTimer->start(iCoalesceInterval);
+            }
+        }
+    }
+}
 
-    switch (iType) {
-    case NR:
-        // Return SS-RSRP value. Reference: 3GPP TS 36.133, sub-clause 9.11
-        signalLevelDbm = inRange(-iProperties[Property_ssRsrp], -140, -44);
-        break;
-    case LTE:
-        // Return RSRP value. Reference: 3GPP TS 36.133, sub-clause 9.1.4
-        signalLevelDbm = inRange(-iProperties[Property_rsrp], -140, -44);
-        break;
-    case WCDMA:
-    case GSM:
-        // Return RSSI. Reference: TS 27.007 sub clause 8.5
-        signalLevelDbm = getRssiDbm(iProperties[Property_signalStrength]);
-        break;
-    case UNKNOWN:
-        break;
+void QOfonoExtCell::Private::emitQueuedChanges()
+{
+    const quint64 changes = iPendingChanges;
+
+    if (changes) {
+        QOfonoExtCell* cell = iParent;
+
+        iPendingChanges = 0;
+        if (changes & SignalChanges) {
+            iLastSignalNotification.start();
+        }
+        // Remember what has been reported, for throttleChanges(). The
+        // changes it has dropped are measured against the old values.
+        if (changes & (Q_UINT64_C(1) << PropertySignalLevelDbm)) {
+            iNotifiedSignalLevelDbm = data()->iSignalLevelDbm;
+        }
+        for (int i=0; i<PropertyCount; i++) {
+            if (changes & (Q_UINT64_C(1) << i)) {
+                iNotifiedValues[i] = data()->iProperties[i];
+                Q_EMIT (cell->*(Properties[i].signal))();
+                Properties[i].propertyChanged(cell, Properties[i].name, data()->iProperties[i]);
+            }
+        }
+        for (int i=PropertyNci; i<=PropertyValid; i++) {
+            if (changes & (Q_UINT64_C(1) << i)) {
+                switch ((Property)i) {
+                case PropertyNci:
+                    Q_EMIT cell->nciChanged();
+                    break;
+                case PropertyType:
+                    Q_EMIT cell->typeChanged();
+                    break;
+                case PropertyRegistered:
+                    Q_EMIT cell->registeredChanged();
+                    break;
+                case PropertySignalLevelDbm:
+                    Q_EMIT cell->signalLevelDbmChanged();
+                    break;
+                case PropertyValid:
+                    Q_EMIT cell->validChanged();
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+        Q_EMIT cell->changed(changes);
     }
+}
 
-    if (iSignalLevelDbm != signalLevelDbm) {
-        iSignalLevelDbm = signalLevelDbm;
-        return true;
+void QOfonoExtCell::Private::setCoalesceInterval(int aMilliseconds)
+{
+    iCoalesceInterval = qMax(aMilliseconds, -1);
+    if (iChangeTimer && iChangeTimer->isActive()) {
+        if (iCoalesceInterval < 0) {
+            // Coalescing has been switched off, deliver what we have
+            iChangeTimer->stop();
+            emitQueuedChanges();
+        } else {
+            iChangeTimer->start(iCoalesceInterval);
+        }
+    }
+}
+
+void QOfonoExtCell::Private::setSignalInterval(int aMilliseconds)
+{
+    iSignalInterval = qMax(aMilliseconds, 0);
+    if (iSignalTimer && iSignalTimer->isActive()) {
+        // Re-evaluate the held changes against the new interval
+        iSignalTimer->stop();
+        emitHeldChanges();
     }
-    return false;
 }
 
 // ==========================================================================
@@ -419,24 +1141,20 @@ bool QOfonoExtCell::Private::updateSignalLevelDbm()
 
 QOfonoExtCell::QOfonoExtCell(QObject* aParent) :
     QObject(aParent),
-    iPrivate(Q_NULLPTR)
+    iPrivate(new Private(this))
 {
 }
 
 QOfonoExtCell::QOfonoExtCell(QString aPath) :
-    iPrivate(new Private(aPath, this))
+    iPrivate(new Private(this))
 {
-    iPrivate->updateAllAsync();
+    iPrivate->setPath(aPath, false, false);
 }
 
 QOfonoExtCell::QOfonoExtCell(QString aPath, bool aMayBlock) : // Since 1.0.27
-    iPrivate(new Private(aPath, this))
+    iPrivate(new Private(this))
 {
-    if (aMayBlock) {
-        iPrivate->getAllSyncInit();
-    } else {
-        iPrivate->updateAllAsync();
-    }
+    iPrivate->setPath(aPath, aMayBlock, false);
 }
 
 QOfonoExtCell::~QOfonoExtCell()
@@ -445,60 +1163,133 @@ QOfonoExtCell::~QOfonoExtCell()
 
 bool QOfonoExtCell::valid() const
 {
-    return iPrivate && iPrivate->iValid;
+    return iPrivate->data()->iValid;
+}
+
+void QOfonoExtCell::whenValid(QObject* aContext, std::function<void()> aCallback) // Since 1.0.33
+{
+    QOfonoExt::whenValid(this, &QOfonoExtCell::validChanged, aContext, aCallback);
 }
 
 QOfonoExtCell::Type QOfonoExtCell::type() const
 {
-    return iPrivate ? iPrivate->iType : UNKNOWN;
+    return iPrivate->data()->iType;
 }
 
 bool QOfonoExtCell::registered() const
 {
-    return iPrivate && iPrivate->iRegistered;
+    return iPrivate->data()->iRegistered;
 }
 
 QString QOfonoExtCell::path() const
 {
-    return iPrivate ? iPrivate->path() : QString();
+    return iPrivate->path();
 }
 
 void QOfonoExtCell::setPath(QString aPath)
 {
     if (path() != aPath) {
-        const bool wasValid = valid();
-        const bool wasRegistered = registered();
-        const Type prevType = type();
-        delete iPrivate;
-        iPrivate = new Private(aPath, this);
-        iPrivate->updateAllAsync();
-        if (valid() != wasValid) {
-            Q_EMIT validChanged();
-        }
-        if (registered() != wasRegistered) {
-            Q_EMIT registeredChanged();
-        }
-        if (type() != prevType) {
-            Q_EMIT typeChanged();
-        }
+        iPrivate->setPath(aPath, false, true);
         Q_EMIT pathChanged();
     }
 }
 
+QOfonoExtCellData QOfonoExtCell::data() const // Since 1.0.33
+{
+    return QOfonoExtCellData(const_cast<QOfonoExtCellData::Private*>(iPrivate->data()));
+}
+
+bool QOfonoExtCell::setWorkerThreadEnabled(bool aEnabled, int aBatchInterval)
+{
+    const int interval = aEnabled ? qMax(aBatchInterval, 0) : -1;
+    if (interval != Private::sWorkerBatchInterval) {
+        // The receiving end is set up when the first cell gets created
+        if (Private::Demux::exists()) {
+            qWarning() << "Can't change the worker thread setting while"
+                " cells exist";
+            return false;
+        }
+        Private::sWorkerBatchInterval = interval;
+    }
+    return true;
+}
+
+bool QOfonoExtCell::workerThreadEnabled()
+{
+    return Private::sWorkerBatchInterval >= 0;
+}
+
+int QOfonoExtCell::coalesceInterval() const
+{
+    return iPrivate->iCoalesceInterval;
+}
+
+void QOfonoExtCell::setCoalesceInterval(int aMilliseconds)
+{
+    if (iPrivate->iCoalesceInterval != qMax(aMilliseconds, -1)) {
+        iPrivate->setCoalesceInterval(aMilliseconds);
+        Q_EMIT coalesceIntervalChanged();
+    }
+}
+
+int QOfonoExtCell::signalInterval() const
+{
+    return iPrivate->iSignalInterval;
+}
+
+void QOfonoExtCell::setSignalInterval(int aMilliseconds)
+{
+    if (iPrivate->iSignalInterval != qMax(aMilliseconds, 0)) {
+        iPrivate->setSignalInterval(aMilliseconds);
+        Q_EMIT signalIntervalChanged();
+    }
+}
+
+int QOfonoExtCell::signalThreshold() const
+{
+    return iPrivate->iSignalThreshold;
+}
+
+void QOfonoExtCell::setSignalThreshold(int aDelta)
+{
+    if (iPrivate->iSignalThreshold != qMax(aDelta, 0)) {
+        iPrivate->iSignalThreshold = qMax(aDelta, 0);
+        Q_EMIT signalThresholdChanged();
+    }
+}
+
+int QOfonoExtCell::signalBars() const
+{
+    return iPrivate->iSignalBars;
+}
+
+void QOfonoExtCell::setSignalBars(int aBars)
+{
+    if (iPrivate->iSignalBars != qMax(aBars, 0)) {
+        iPrivate->iSignalBars = qMax(aBars, 0);
+        Q_EMIT signalBarsChanged();
+    }
+}
+
+int QOfonoExtCell::signalBar() const
+{
+    return iPrivate->signalBar(iPrivate->data()->iSignalLevelDbm);
+}
+
 int QOfonoExtCell::signalLevelDbm() const
 {
-    return iPrivate ? iPrivate->iSignalLevelDbm : QOFONOEXT_INVALID_VALUE;
+    return iPrivate->data()->iSignalLevelDbm;
 }
 
-#define PropertyGet_(x) \
+#define PropertyGet_(x,X) \
     int QOfonoExtCell::x() const {\
-        return Private::valueInt(iPrivate, Private::Property_##x); \
+        return Private::valueInt(iPrivate, Property##X); \
     }
 CELL_PROPERTIES(PropertyGet_)
 
 QString QOfonoExtCell::nciString() const
 {
-    qint64 value = iPrivate ? iPrivate->iNci : INT64_MAX;
+    qint64 value = iPrivate->data()->iNci;
     if (value != INT64_MAX) {
         return QString::number(value);
     }
@@ -18,6 +18,8 @@
 
 #include "qofonoext_types.h"
 
+class QOfonoExtCellData;
+
 class QOFONOEXT_EXPORT QOfonoExtCell : public QObject
 {
     Q_OBJECT
@@ -54,8 +56,13 @@ class QOFONOEXT_EXPORT QOfonoExtCell : public QObject
     Q_PROPERTY(int csiRsrq READ csiRsrq NOTIFY csiRsrqChanged)
     Q_PROPERTY(int csiSinr READ csiSinr NOTIFY csiSinrChanged)
     Q_PROPERTY(int signalLevelDbm READ signalLevelDbm NOTIFY signalLevelDbmChanged)
+    Q_PROPERTY(int coalesceInterval READ coalesceInterval WRITE setCoalesceInterval NOTIFY coalesceIntervalChanged)
+    Q_PROPERTY(int signalInterval READ signalInterval WRITE setSignalInterval NOTIFY signalIntervalChanged)
+    Q_PROPERTY(int signalThreshold READ signalThreshold WRITE setSignalThreshold NOTIFY signalThresholdChanged)
+    Q_PROPERTY(int signalBars READ signalBars WRITE setSignalBars NOTIFY signalBarsChanged)
     Q_ENUMS(Type)
     Q_ENUMS(Constants)
+    Q_ENUMS(Property)
 
 public:
     enum Type {
@@ -71,8 +78,46 @@ public:
         InvalidValue = INT_MAX
     };
 
+    enum Property { // Since 1.0.33
+        PropertyUnknown = -1,
+        // Integer properties
+        PropertyMcc,
+        PropertyMnc,
+        PropertySignalStrength,
+        PropertyLac,
+        PropertyCid,
+        PropertyArfcn,
+        PropertyBsic,
+        PropertyBitErrorRate,
+        PropertyPsc,
+        PropertyUarfcn,
+        PropertyCi,
+        PropertyPci,
+        PropertyTac,
+        PropertyEarfcn,
+        PropertyRsrp,
+        PropertyRsrq,
+        PropertyRssnr,
+        PropertyCqi,
+        PropertyTimingAdvance,
+        PropertyNrarfcn,
+        PropertySsRsrp,
+        PropertySsRsrq,
+        PropertySsSinr,
+        PropertyCsiRsrp,
+        PropertyCsiRsrq,
+        PropertyCsiSinr,
+        PropertyCount, // Number of integer properties
+        // Everything else
+        PropertyNci = PropertyCount,
+        PropertyType,
+        PropertyRegistered,
+        PropertySignalLevelDbm,
+        PropertyValid
+    };
+
     explicit QOfonoExtCell(QObject* aParent = Q_NULLPTR);
-    QOfonoExtCell(QString aPath, bool aMayBlock); // Since 1.0.27
+    QOfonoExtCell(QString aPath, bool aMayBlock); // Since 1.0.27, see whenValid()
     QOfonoExtCell(QString aPath);
     ~QOfonoExtCell();
 
@@ -83,6 +128,10 @@ public:
     Type type() const;
     bool registered() const;
 
+    // Invokes the callback when the cell becomes valid (or right away
+    // if it already is), unless aContext gets destroyed first. Since 1.0.33
+    void whenValid(QObject* aContext, std::function<void()> aCallback);
+
     // All types:
     int mcc() const;
     int mnc() const;
@@ -125,6 +174,46 @@ public:
     int csiRsrq() const;
     int csiSinr() const;
 
+    // Implicitly shared copy of the current state. Since 1.0.33
+    QOfonoExtCellData data() const;
+
+    // Negative interval (default) disables coalescing, zero delivers
+    // the changes once per event loop pass. Since 1.0.33
+    int coalesceInterval() const;
+    void setCoalesceInterval(int aMilliseconds);
+
+    // Throttling of the signal quality properties (signalStrength,
+    // bitErrorRate, rsrp, rsrq, rssnr, cqi, ssRsrp, ssRsrq, ssSinr,
+    // csiRsrp, csiRsrq, csiSinr and signalLevelDbm). The getters always
+    // return the current values, only the change notifications are
+    // throttled. Zero (default) disables each kind of throttling.
+    //
+    // signalInterval: minimum interval between notifications, in ms.
+    // signalThreshold: a change is only reported once the value has moved
+    // by at least this much (dB for most properties) since the last report.
+    // signalBars: maps signalLevelDbm to this many bars, the changes are
+    // only reported when the number of bars changes (overrides threshold).
+    //
+    // Since 1.0.33
+    int signalInterval() const;
+    void setSignalInterval(int aMilliseconds);
+    int signalThreshold() const;
+    void setSignalThreshold(int aDelta);
+    int signalBars() const;
+    void setSignalBars(int aBars);
+    int signalBar() const; // 1..signalBars, 0 if unknown or bars are off
+
+    // Receives and parses the cell signals (PropertyChanged,
+    // RegisteredChanged and Removed) on a separate thread, which delivers
+    // them to the cells in batches at most once per aBatchInterval
+    // milliseconds. GetAll calls, including demarshalling of the replies,
+    // and CellInfo stay on the thread which owns the cells.
+    //
+    // The setting can only be changed while no cells exist, otherwise
+    // it stays as it is and false is returned. Since 1.0.33
+    static bool setWorkerThreadEnabled(bool aEnabled, int aBatchInterval = 0);
+    static bool workerThreadEnabled();
+
 Q_SIGNALS:
     void validChanged();
     void pathChanged();
@@ -160,6 +249,13 @@ Q_SIGNALS:
     void signalLevelDbmChanged();
     void propertyChanged(QString name, int value); // int properties
     void removed();
+    void coalesceIntervalChanged(); // Since 1.0.33
+    void signalIntervalChanged(); // Since 1.0.33
+    void signalThresholdChanged(); // Since 1.0.33
+    void signalBarsChanged(); // Since 1.0.33
+    // Follows the individual signals, with a (1 << Property) bit set
+    // for each property that has changed. Since 1.0.33
+    void changed(quint64 properties);
 
 private:
     class Private;
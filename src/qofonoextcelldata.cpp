@@ -0,0 +1,282 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include "qofonoextcelldata_p.h"
+
+namespace {
+    const QString kTypeGsm("gsm");
+    const QString kTypeWcdma("wcdma");
+    const QString kTypeLte("lte");
+    const QString kTypeNr("nr");
+
+    // Make sure that CELL_PROPERTIES matches QOfonoExtCell::Property
+    enum PropertyOrder {
+        #define PropertyOrder_(x,X) PropertyOrder_##x,
+        CELL_PROPERTIES(PropertyOrder_)
+        PropertyOrderCount
+    };
+    #define PropertyCheck_(x,X) Q_STATIC_ASSERT((int)QOfonoExtCell::Property##X == \
+        (int)PropertyOrder_##x);
+    CELL_PROPERTIES(PropertyCheck_)
+    Q_STATIC_ASSERT((int)QOfonoExtCell::PropertyCount == (int)PropertyOrderCount);
+}
+
+// ==========================================================================
+// QOfonoExtCellData::Private
+// ==========================================================================
+
+const char* const QOfonoExtCellData::Private::PropertyNames[] = {
+    #define PropertyName_(x,X) #x,
+    CELL_PROPERTIES(PropertyName_)
+};
+
+QOfonoExtCellData::Private::Private(const QString& aPath) :
+    iPath(aPath),
+    iValid(false),
+    iRegistered(false),
+    iType(QOfonoExtCell::Unknown),
+    iSignalLevelDbm(QOFONOEXT_INVALID_VALUE),
+    iNci(INT64_MAX)
+{
+    invalidateValues(iProperties, &iNci);
+}
+
+void QOfonoExtCellData::Private::setGetAllReply(const GetAllReply& aReply)
+{
+    // Take the arguments straight from the message. argumentAt<3>()
+    // would build a QVariantMap only to throw it away.
+    const QList<QVariant> args(aReply.reply().arguments());
+    if (args.count() == 4) {
+        // Ignore args[0] version
+        iType = typeFromString(args.at(1).toString());
+        iRegistered = args.at(2).toBool();
+        parseProperties(qvariant_cast<QDBusArgument>(args.at(3)), iProperties, &iNci);
+        iSignalLevelDbm = signalLevelDbm(iType, iProperties);
+        iValid = true;
+    }
+}
+
+QOfonoExtCell::Type QOfonoExtCellData::Private::typeFromString(const QString& aType)
+{
+    return (aType == kTypeGsm) ? QOfonoExtCell::GSM :
+           (aType == kTypeLte) ? QOfonoExtCell::LTE :
+           (aType == kTypeWcdma) ? QOfonoExtCell::WCDMA :
+           (aType == kTypeNr) ? QOfonoExtCell::NR :
+           QOfonoExtCell::Unknown;
+}
+
+QOfonoExtCell::Property QOfonoExtCellData::Private::propertyFromString(const QString& aProperty)
+{
+    const QChar* chars = aProperty.constData();
+    const int n = aProperty.length();
+    uint hash = PropertyHashSeed;
+
+    for (int i=0; i<n; i++) {
+        const ushort c = chars[i].unicode();
+        if (c > 0x7f) {
+            // All known names are ASCII
+            return QOfonoExtCell::PropertyUnknown;
+        }
+        hash = (hash * 33) ^ c;
+    }
+
+    // Duplicate case values (i.e. hash collisions between the known
+    // names) would break the build, so each hash maps to one property
+    QOfonoExtCell::Property p;
+    switch (hash) {
+    #define PropertyCase_(x,X) case propertyHash(#x): p = QOfonoExtCell::Property##X; break;
+    CELL_PROPERTIES(PropertyCase_)
+    default:
+        return QOfonoExtCell::PropertyUnknown;
+    }
+
+    // An unknown key may still produce the same hash as a known one
+    return (aProperty == QLatin1String(PropertyNames[p])) ? p :
+        QOfonoExtCell::PropertyUnknown;
+}
+
+void QOfonoExtCellData::Private::invalidateValues(int* aProperties, qint64* aNci)
+{
+    for (int i=0; i<QOfonoExtCell::PropertyCount; i++) {
+        aProperties[i] = QOFONOEXT_INVALID_VALUE;
+    }
+    *aNci = INT64_MAX;
+}
+
+// Walks the a{sv} dictionary in place, storing the values as they come.
+// Allocating the key strings is unavoidable with QDBusArgument, but there's
+// no QVariantMap in between and no extra copies of the keys and values.
+void QOfonoExtCellData::Private::parseProperties(const QDBusArgument& aVariants,
+    int* aProperties, qint64* aNci)
+{
+    // Unpack properties (they are all integers)
+    invalidateValues(aProperties, aNci);
+    if (aVariants.currentType() == QDBusArgument::MapType) {
+        QString key;
+        QDBusVariant value;
+
+        aVariants.beginMap();
+        while (!aVariants.atEnd()) {
+            aVariants.beginMapEntry();
+            aVariants >> key >> value;
+            aVariants.endMapEntry();
+
+            const QVariant& variant(value.variant());
+            if (key == QLatin1String("nci")) {
+                bool ok = false;
+                qint64 int64Value = variant.toLongLong(&ok);
+                if (ok) {
+                    *aNci = int64Value;
+                }
+            } else {
+                int number;
+                if (intValue(variant, &number)) {
+                    QOfonoExtCell::Property p = propertyFromString(key);
+                    if (p != QOfonoExtCell::PropertyUnknown) {
+                        aProperties[p] = number;
+                    }
+                }
+            }
+        }
+        aVariants.endMap();
+    }
+}
+
+bool QOfonoExtCellData::Private::intValue(const QVariant& aValue, int* aInt)
+{
+    // D-Bus "i" arrives as int, skip the conversion machinery
+    if (aValue.userType() == QMetaType::Int) {
+        *aInt = *static_cast<const int*>(aValue.constData());
+        return true;
+    } else {
+        bool ok = false;
+        *aInt = aValue.toInt(&ok);
+        return ok;
+    }
+}
+
+int QOfonoExtCellData::Private::signalLevelDbm(QOfonoExtCell::Type aType, const int* aProperties)
+{
+    switch (aType) {
+    case QOfonoExtCell::NR:
+        // Return SS-RSRP value. Reference: 3GPP TS 36.133, sub-clause 9.11
+        return inRange(-aProperties[QOfonoExtCell::PropertySsRsrp], -140, -44);
+    case QOfonoExtCell::LTE:
+        // Return RSRP value. Reference: 3GPP TS 36.133, sub-clause 9.1.4
+        return inRange(-aProperties[QOfonoExtCell::PropertyRsrp], -140, -44);
+    case QOfonoExtCell::WCDMA:
+    case QOfonoExtCell::GSM:
+        // Return RSSI. Reference: TS 27.007 sub clause 8.5
+        return getRssiDbm(aProperties[QOfonoExtCell::PropertySignalStrength]);
+    case QOfonoExtCell::Unknown:
+        break;
+    }
+    return QOFONOEXT_INVALID_VALUE;
+}
+
+int QOfonoExtCellData::Private::getRssiDbm(int aValue)
+{
+    // Range for RSSI in ASU (0-31, 99) as defined in TS 27.007 8.69
+    return (aValue < 0 || aValue > 31) ? QOFONOEXT_INVALID_VALUE : (-113 + (2 * aValue));
+}
+
+int QOfonoExtCellData::Private::inRange(int aValue, int aMin, int aMax)
+{
+    return (aValue < aMin || aValue > aMax) ? QOFONOEXT_INVALID_VALUE : aValue;
+}
+
+// ==========================================================================
+// QOfonoExtCellData
+// ==========================================================================
+
+QOfonoExtCellData::QOfonoExtCellData() :
+    iPrivate(new Private)
+{
+}
+
+QOfonoExtCellData::QOfonoExtCellData(Private* aPrivate) :
+    iPrivate(aPrivate)
+{
+}
+
+QOfonoExtCellData::QOfonoExtCellData(const QOfonoExtCellData& aData) :
+    iPrivate(aData.iPrivate)
+{
+}
+
+QOfonoExtCellData::~QOfonoExtCellData()
+{
+}
+
+QOfonoExtCellData& QOfonoExtCellData::operator=(const QOfonoExtCellData& aData)
+{
+    iPrivate = aData.iPrivate;
+    return *this;
+}
+
+bool QOfonoExtCellData::operator==(const QOfonoExtCellData& aData) const
+{
+    const Private* d1 = iPrivate.constData();
+    const Private* d2 = aData.iPrivate.constData();
+
+    // Copies of the same data share the pointer, that's the fast path
+    return d1 == d2 || (d1->iValid == d2->iValid &&
+        d1->iRegistered == d2->iRegistered &&
+        d1->iType == d2->iType &&
+        d1->iNci == d2->iNci &&
+        !memcmp(d1->iProperties, d2->iProperties, sizeof(d1->iProperties)) &&
+        d1->iPath == d2->iPath);
+}
+
+bool QOfonoExtCellData::isValid() const
+{
+    return iPrivate->iValid;
+}
+
+QString QOfonoExtCellData::path() const
+{
+    return iPrivate->iPath;
+}
+
+QOfonoExtCell::Type QOfonoExtCellData::type() const
+{
+    return iPrivate->iType;
+}
+
+bool QOfonoExtCellData::registered() const
+{
+    return iPrivate->iRegistered;
+}
+
+qint64 QOfonoExtCellData::nci() const
+{
+    return iPrivate->iNci;
+}
+
+QString QOfonoExtCellData::nciString() const
+{
+    const qint64 value = iPrivate->iNci;
+    return (value != INT64_MAX) ? QString::number(value) : QString();
+}
+
+int QOfonoExtCellData::signalLevelDbm() const
+{
+    return iPrivate->iSignalLevelDbm;
+}
+
+int QOfonoExtCellData::value(QOfonoExtCell::Property aProperty) const
+{
+    return (aProperty >= 0 && aProperty < QOfonoExtCell::PropertyCount) ?
+        iPrivate->iProperties[aProperty] : QOFONOEXT_INVALID_VALUE;
+}
@@ -0,0 +1,57 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef QOFONOEXTCELLDATA_H
+#define QOFONOEXTCELLDATA_H
+
+#include "qofonoextcell.h"
+
+// Implicitly shared snapshot of the cell state (since 1.0.33)
+class QOFONOEXT_EXPORT QOfonoExtCellData
+{
+public:
+    QOfonoExtCellData();
+    QOfonoExtCellData(const QOfonoExtCellData& aData);
+    ~QOfonoExtCellData();
+
+    QOfonoExtCellData& operator=(const QOfonoExtCellData& aData);
+    void swap(QOfonoExtCellData& aData) { iPrivate.swap(aData.iPrivate); }
+
+    bool operator==(const QOfonoExtCellData& aData) const;
+    bool operator!=(const QOfonoExtCellData& aData) const
+        { return !operator==(aData); }
+
+    bool isValid() const;
+    QString path() const;
+    QOfonoExtCell::Type type() const;
+    bool registered() const;
+    qint64 nci() const;
+    QString nciString() const;
+    int signalLevelDbm() const;
+
+    // Integer properties, InvalidValue if unknown
+    int value(QOfonoExtCell::Property aProperty) const;
+
+private:
+    friend class QOfonoExtCell;
+    friend class QOfonoExtCellInfo;
+    class Private;
+    QOfonoExtCellData(Private* aPrivate);
+    QSharedDataPointer<Private> iPrivate;
+};
+
+Q_DECLARE_SHARED(QOfonoExtCellData)
+Q_DECLARE_METATYPE(QOfonoExtCellData)
+
+#endif // QOFONOEXTCELLDATA_H
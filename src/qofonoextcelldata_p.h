@@ -0,0 +1,79 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef QOFONOEXTCELLDATA_PRIVATE_H
+#define QOFONOEXTCELLDATA_PRIVATE_H
+
+#include "qofonoextcelldata.h"
+#include "qofonoext_p.h"
+
+#define OFONO_CELL_INTERFACE "org.nemomobile.ofono.Cell"
+
+#define QOFONOEXT_INVALID_VALUE   ((int)QOfonoExtCell::InvalidValue)
+
+// Must be in sync with QOfonoExtCell::Property
+#define CELL_PROPERTIES(p) \
+    p(mcc,Mcc) p(mnc,Mnc) p(signalStrength,SignalStrength) p(lac,Lac) \
+    p(cid,Cid) p(arfcn,Arfcn) p(bsic,Bsic) p(bitErrorRate,BitErrorRate) \
+    p(psc,Psc) p(uarfcn,Uarfcn) p(ci,Ci) p(pci,Pci) p(tac,Tac) \
+    p(earfcn,Earfcn) p(rsrp,Rsrp) p(rsrq,Rsrq) p(rssnr,Rssnr) p(cqi,Cqi) \
+    p(timingAdvance,TimingAdvance) p(nrarfcn,Nrarfcn) p(ssRsrp,SsRsrp) \
+    p(ssRsrq,SsRsrq) p(ssSinr,SsSinr) p(csiRsrp,CsiRsrp) p(csiRsrq,CsiRsrq) \
+    p(csiSinr,CsiSinr)
+
+class QOfonoExtCellData::Private : public QSharedData
+{
+public:
+    enum {
+        PropertyHashSeed = 5381
+    };
+
+    typedef QDBusPendingReply <
+        int,          // 0. version
+        QString,      // 1. type
+        bool,         // 2. registered
+        QVariantMap>  // 3. properties
+        GetAllReply;
+
+    static const char* const PropertyNames[QOfonoExtCell::PropertyCount];
+
+    Private(const QString& aPath = QString());
+
+    void setGetAllReply(const GetAllReply& aReply);
+
+    static QOfonoExtCell::Type typeFromString(const QString& aType);
+    static QOfonoExtCell::Property propertyFromString(const QString& aProperty);
+    static void invalidateValues(int* aProperties, qint64* aNci);
+    static void parseProperties(const QDBusArgument& aVariants, int* aProperties, qint64* aNci);
+    static bool intValue(const QVariant& aValue, int* aInt);
+    static int signalLevelDbm(QOfonoExtCell::Type aType, const int* aProperties);
+    static int getRssiDbm(int aSignalStrength);
+    static int inRange(int aValue, int aRangeMin, int aRangeMax);
+
+    // djb2 (xor variant). The same hash is calculated at compile time for
+    // the names in CELL_PROPERTIES and at run time for the incoming keys.
+    static constexpr uint propertyHash(const char* aName, uint aHash = PropertyHashSeed)
+        { return *aName ? propertyHash(aName + 1, (aHash * 33) ^ (uchar)*aName) : aHash; }
+
+public:
+    QString iPath;
+    bool iValid;
+    bool iRegistered;
+    QOfonoExtCell::Type iType;
+    int iProperties[QOfonoExtCell::PropertyCount];
+    int iSignalLevelDbm;
+    qint64 iNci;
+};
+
+#endif // QOFONOEXTCELLDATA_PRIVATE_H
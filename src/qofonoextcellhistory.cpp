@@ -0,0 +1,409 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include "qofonoextcellhistory.h"
+#include "qofonoextcelldata.h"
+
+#include <QDateTime>
+#include <QPointer>
+
+#include <algorithm>
+
+// ==========================================================================
+// QOfonoExtCellHistory::Private
+//
+// Samples are numbered sequentially, sample N is stored in slot N % capacity.
+// Per-property arrays are laid out as [property * capacity + slot].
+//
+// For each sample we remember the sum and the number of valid values of
+// all the samples before it, which gives the sum over any suffix of the
+// history in O(1). Minimum and maximum are tracked by monotonic queues of
+// sample numbers (the classic sliding window algorithm), the minimum over
+// a suffix is at the first queued sample which is not older than the
+// beginning of the suffix.
+// ==========================================================================
+
+class QOfonoExtCellHistory::Private : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum { PropertyCount = QOfonoExtCell::PropertyCount };
+    enum { InvalidValue = QOfonoExtCell::InvalidValue };
+
+    struct Queue {
+        Queue() : iHead(0), iSize(0) {}
+        int iHead;
+        int iSize;
+    };
+
+    Private(QOfonoExtCellHistory* aParent, int aCapacity);
+
+    void setCell(QOfonoExtCell* aCell);
+    void allocate(int aCapacity);
+    bool clear();
+    void addSample(const QOfonoExtCellData& aData);
+
+    int slot(qint64 aSeq) const { return (int)(aSeq % iCapacity); }
+    int offset(int aProperty, qint64 aSeq) const
+        { return aProperty * iCapacity + slot(aSeq); }
+    qint64 oldest() const { return iSeq - iCount; }
+    qint64 windowStart(int aWindow) const;
+    int extremum(int aProperty, int aWindow, bool aMin) const;
+    qreal mean(int aProperty, int aWindow) const;
+    int percentile(int aProperty, qreal aPercent, int aWindow) const;
+
+private:
+    void push(bool aMin, int aProperty, qint64 aSeq, int aValue);
+    qint64 queueAt(bool aMin, int aProperty, int aIndex) const;
+
+private Q_SLOTS:
+    void onCellChanged(quint64 aProperties);
+    void onCellDestroyed();
+
+public:
+    QOfonoExtCellHistory* iParent;
+    QPointer<QOfonoExtCell> iCell;
+    int iCapacity;
+    int iCount;
+    qint64 iSeq;                    // Number of the next sample
+    QVector<qint64> iTimestamps;    // [slot]
+    QVector<int> iValues;           // [property][slot]
+    QVector<qint64> iPrefixSum;     // [property][slot]
+    QVector<qint64> iPrefixCount;   // [property][slot]
+    QVector<qint64> iMinQueue;      // [property][capacity]
+    QVector<qint64> iMaxQueue;      // [property][capacity]
+    mutable QVector<int> iScratch;  // [capacity]
+    qint64 iTotalSum[PropertyCount];
+    qint64 iTotalCount[PropertyCount];
+    Queue iMin[PropertyCount];
+    Queue iMax[PropertyCount];
+};
+
+QOfonoExtCellHistory::Private::Private(QOfonoExtCellHistory* aParent, int aCapacity) :
+    QObject(aParent),
+    iParent(aParent),
+    iCapacity(0),
+    iCount(0),
+    iSeq(0)
+{
+    allocate(aCapacity);
+}
+
+void QOfonoExtCellHistory::Private::allocate(int aCapacity)
+{
+    iCapacity = qMax(aCapacity, 1);
+    iTimestamps.fill(0, iCapacity);
+    iValues.fill(InvalidValue, iCapacity * PropertyCount);
+    iPrefixSum.fill(0, iCapacity * PropertyCount);
+    iPrefixCount.fill(0, iCapacity * PropertyCount);
+    iMinQueue.fill(0, iCapacity * PropertyCount);
+    iMaxQueue.fill(0, iCapacity * PropertyCount);
+    iScratch.fill(0, iCapacity);
+    clear();
+}
+
+bool QOfonoExtCellHistory::Private::clear()
+{
+    const bool wasEmpty = !iCount;
+    iCount = 0;
+    iSeq = 0;
+    for (int p = 0; p < PropertyCount; p++) {
+        iTotalSum[p] = 0;
+        iTotalCount[p] = 0;
+        iMin[p] = Queue();
+        iMax[p] = Queue();
+    }
+    return !wasEmpty;
+}
+
+void QOfonoExtCellHistory::Private::setCell(QOfonoExtCell* aCell)
+{
+    if (iCell) {
+        iCell->disconnect(this);
+    }
+    iCell = aCell;
+    if (aCell) {
+        connect(aCell, SIGNAL(changed(quint64)),
+            SLOT(onCellChanged(quint64)));
+        connect(aCell, SIGNAL(destroyed(QObject*)),
+            SLOT(onCellDestroyed()));
+        if (aCell->valid()) {
+            addSample(aCell->data());
+        }
+    }
+}
+
+void QOfonoExtCellHistory::Private::onCellChanged(quint64 aProperties)
+{
+    // Integer properties or validity
+    const quint64 mask = ((Q_UINT64_C(1) << PropertyCount) - 1) |
+        (Q_UINT64_C(1) << QOfonoExtCell::PropertyValid);
+    if (iCell && iCell->valid() && (aProperties & mask)) {
+        addSample(iCell->data());
+    }
+}
+
+void QOfonoExtCellHistory::Private::onCellDestroyed()
+{
+    Q_EMIT iParent->cellChanged();
+}
+
+qint64 QOfonoExtCellHistory::Private::queueAt(bool aMin, int aProperty, int aIndex) const
+{
+    const Queue& q = (aMin ? iMin : iMax)[aProperty];
+    const QVector<qint64>& buf = aMin ? iMinQueue : iMaxQueue;
+    return buf.at(aProperty * iCapacity + (q.iHead + aIndex) % iCapacity);
+}
+
+void QOfonoExtCellHistory::Private::push(bool aMin, int aProperty, qint64 aSeq, int aValue)
+{
+    Queue& q = (aMin ? iMin : iMax)[aProperty];
+    QVector<qint64>& buf = aMin ? iMinQueue : iMaxQueue;
+    qint64* data = buf.data() + aProperty * iCapacity;
+
+    // Drop the samples which have fallen out of the history
+    const qint64 first = oldest();
+    while (q.iSize > 0 && data[q.iHead] < first) {
+        q.iHead = (q.iHead + 1) % iCapacity;
+        q.iSize--;
+    }
+
+    if (aValue != InvalidValue) {
+        // Drop the samples which can no longer be the extremum
+        while (q.iSize > 0) {
+            const qint64 last = data[(q.iHead + q.iSize - 1) % iCapacity];
+            const int v = iValues.at(offset(aProperty, last));
+            if (aMin ? (v < aValue) : (v > aValue)) {
+                break;
+            }
+            q.iSize--;
+        }
+        data[(q.iHead + q.iSize) % iCapacity] = aSeq;
+        q.iSize++;
+    }
+}
+
+void QOfonoExtCellHistory::Private::addSample(const QOfonoExtCellData& aData)
+{
+    const qint64 seq = iSeq++;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    // Keep the timestamps monotonic, windowStart() relies on that
+    iTimestamps[slot(seq)] = (seq > 0) ? qMax(now, iTimestamps.at(slot(seq - 1))) : now;
+    const bool grew = (iCount < iCapacity);
+    if (grew) {
+        iCount++;
+    }
+
+    for (int p = 0; p < PropertyCount; p++) {
+        const int i = offset(p, seq);
+        const int value = aData.value((QOfonoExtCell::Property)p);
+        iValues[i] = value;
+        iPrefixSum[i] = iTotalSum[p];
+        iPrefixCount[i] = iTotalCount[p];
+        if (value != InvalidValue) {
+            iTotalSum[p] += value;
+            iTotalCount[p]++;
+        }
+        push(true, p, seq, value);
+        push(false, p, seq, value);
+    }
+
+    if (grew) {
+        Q_EMIT iParent->countChanged();
+    }
+    Q_EMIT iParent->sampleAdded();
+}
+
+qint64 QOfonoExtCellHistory::Private::windowStart(int aWindow) const
+{
+    qint64 lo = oldest();
+    if (aWindow > 0 && iCount > 0) {
+        // First sample not older than the window (binary search)
+        const qint64 since = QDateTime::currentMSecsSinceEpoch() - aWindow;
+        qint64 hi = iSeq;
+        while (lo < hi) {
+            const qint64 mid = lo + (hi - lo) / 2;
+            if (iTimestamps.at(slot(mid)) < since) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+    }
+    return lo;
+}
+
+int QOfonoExtCellHistory::Private::extremum(int aProperty, int aWindow, bool aMin) const
+{
+    if (aProperty >= 0 && aProperty < PropertyCount) {
+        const qint64 from = windowStart(aWindow);
+        const Queue& q = (aMin ? iMin : iMax)[aProperty];
+
+        // Queued sample numbers are increasing (binary search again)
+        int lo = 0, hi = q.iSize;
+        while (lo < hi) {
+            const int mid = (lo + hi) / 2;
+            if (queueAt(aMin, aProperty, mid) < from) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo < q.iSize) {
+            return iValues.at(offset(aProperty, queueAt(aMin, aProperty, lo)));
+        }
+    }
+    return InvalidValue;
+}
+
+qreal QOfonoExtCellHistory::Private::mean(int aProperty, int aWindow) const
+{
+    if (aProperty >= 0 && aProperty < PropertyCount) {
+        const qint64 from = windowStart(aWindow);
+        if (from < iSeq) {
+            const int i = offset(aProperty, from);
+            const qint64 n = iTotalCount[aProperty] - iPrefixCount.at(i);
+            if (n > 0) {
+                return (qreal)(iTotalSum[aProperty] - iPrefixSum.at(i)) / n;
+            }
+        }
+    }
+    return InvalidValue;
+}
+
+int QOfonoExtCellHistory::Private::percentile(int aProperty, qreal aPercent, int aWindow) const
+{
+    if (aProperty >= 0 && aProperty < PropertyCount) {
+        int* values = iScratch.data();
+        int n = 0;
+        for (qint64 seq = windowStart(aWindow); seq < iSeq; seq++) {
+            const int value = iValues.at(offset(aProperty, seq));
+            if (value != InvalidValue) {
+                values[n++] = value;
+            }
+        }
+        if (n > 0) {
+            const int k = qBound(0, qRound(qBound(0.0, aPercent, 100.0) *
+                (n - 1) / 100), n - 1);
+            std::nth_element(values, values + k, values + n);
+            return values[k];
+        }
+    }
+    return InvalidValue;
+}
+
+// ==========================================================================
+// QOfonoExtCellHistory
+// ==========================================================================
+
+QOfonoExtCellHistory::QOfonoExtCellHistory(QObject* aParent) :
+    QObject(aParent),
+    iPrivate(new Private(this, DefaultCapacity))
+{
+}
+
+QOfonoExtCellHistory::QOfonoExtCellHistory(QOfonoExtCell* aCell, int aCapacity, QObject* aParent) :
+    QObject(aParent),
+    iPrivate(new Private(this, aCapacity))
+{
+    iPrivate->setCell(aCell);
+}
+
+QOfonoExtCellHistory::~QOfonoExtCellHistory()
+{
+}
+
+QOfonoExtCell* QOfonoExtCellHistory::cell() const
+{
+    return iPrivate->iCell.data();
+}
+
+void QOfonoExtCellHistory::setCell(QOfonoExtCell* aCell)
+{
+    if (iPrivate->iCell != aCell) {
+        const bool countChanged = iPrivate->clear();
+        iPrivate->setCell(aCell);
+        Q_EMIT cellChanged();
+        if (countChanged) {
+            Q_EMIT this->countChanged();
+        }
+    }
+}
+
+int QOfonoExtCellHistory::capacity() const
+{
+    return iPrivate->iCapacity;
+}
+
+void QOfonoExtCellHistory::setCapacity(int aCapacity)
+{
+    if (aCapacity > 0 && iPrivate->iCapacity != aCapacity) {
+        const bool countChanged = (iPrivate->iCount > 0);
+        iPrivate->allocate(aCapacity);
+        Q_EMIT capacityChanged();
+        if (countChanged) {
+            Q_EMIT this->countChanged();
+        }
+    }
+}
+
+int QOfonoExtCellHistory::count() const
+{
+    return iPrivate->iCount;
+}
+
+void QOfonoExtCellHistory::clear()
+{
+    if (iPrivate->clear()) {
+        Q_EMIT countChanged();
+    }
+}
+
+qint64 QOfonoExtCellHistory::timestamp(int aIndex) const
+{
+    return (aIndex >= 0 && aIndex < iPrivate->iCount) ?
+        iPrivate->iTimestamps.at(iPrivate->slot(iPrivate->iSeq - 1 - aIndex)) : 0;
+}
+
+int QOfonoExtCellHistory::value(int aProperty, int aIndex) const
+{
+    return (aProperty >= 0 && aProperty < QOfonoExtCell::PropertyCount &&
+        aIndex >= 0 && aIndex < iPrivate->iCount) ?
+        iPrivate->iValues.at(iPrivate->offset(aProperty, iPrivate->iSeq - 1 - aIndex)) :
+        QOfonoExtCell::InvalidValue;
+}
+
+int QOfonoExtCellHistory::minimum(int aProperty, int aWindow) const
+{
+    return iPrivate->extremum(aProperty, aWindow, true);
+}
+
+int QOfonoExtCellHistory::maximum(int aProperty, int aWindow) const
+{
+    return iPrivate->extremum(aProperty, aWindow, false);
+}
+
+qreal QOfonoExtCellHistory::mean(int aProperty, int aWindow) const
+{
+    return iPrivate->mean(aProperty, aWindow);
+}
+
+int QOfonoExtCellHistory::percentile(int aProperty, qreal aPercent, int aWindow) const
+{
+    return iPrivate->percentile(aProperty, aPercent, aWindow);
+}
+
+#include "qofonoextcellhistory.moc"
@@ -0,0 +1,75 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef QOFONOEXTCELLHISTORY_H
+#define QOFONOEXTCELLHISTORY_H
+
+#include "qofonoextcell.h"
+
+// Fixed-capacity history of the integer cell properties (since 1.0.33)
+//
+// A sample of all QOfonoExtCell::Property values is recorded every time
+// the cell reports a change. The storage is allocated upfront, adding a
+// sample doesn't allocate anything. Index 0 is the newest sample.
+//
+// The statistics ignore InvalidValue entries. The window is specified in
+// milliseconds counting back from the current time, zero or negative
+// window means the entire history. Minimum, maximum and mean are O(1)
+// or O(log N), percentile is O(N) in the number of samples in the window.
+// If there are no valid samples, InvalidValue is returned.
+class QOFONOEXT_EXPORT QOfonoExtCellHistory : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QOfonoExtCell* cell READ cell WRITE setCell NOTIFY cellChanged)
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum {
+        DefaultCapacity = 60
+    };
+
+    explicit QOfonoExtCellHistory(QObject* aParent = Q_NULLPTR);
+    QOfonoExtCellHistory(QOfonoExtCell* aCell, int aCapacity, QObject* aParent = Q_NULLPTR);
+    ~QOfonoExtCellHistory();
+
+    QOfonoExtCell* cell() const;
+    void setCell(QOfonoExtCell* aCell);
+
+    // Changing the capacity drops the history
+    int capacity() const;
+    void setCapacity(int aCapacity);
+
+    int count() const;
+
+    Q_INVOKABLE void clear();
+    Q_INVOKABLE qint64 timestamp(int aIndex) const; // msecs since epoch
+    Q_INVOKABLE int value(int aProperty, int aIndex) const;
+    Q_INVOKABLE int minimum(int aProperty, int aWindow = 0) const;
+    Q_INVOKABLE int maximum(int aProperty, int aWindow = 0) const;
+    Q_INVOKABLE qreal mean(int aProperty, int aWindow = 0) const;
+    Q_INVOKABLE int percentile(int aProperty, qreal aPercent, int aWindow = 0) const;
+
+Q_SIGNALS:
+    void cellChanged();
+    void capacityChanged();
+    void countChanged();
+    void sampleAdded();
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // QOFONOEXTCELLHISTORY_H
@@ -14,45 +14,22 @@
 ****************************************************************************/
 
 #include "qofonoextcellinfo.h"
-#include "qofonoext_p.h"
+#include "qofonoextcelldata_p.h"
 
 #include <qofonomodem.h>
 
+#include <algorithm>
+
+static const QString kInterface("org.nemomobile.ofono.CellInfo");
 static const QString kMethodGetCells("GetCells");
+static const QString kSignalCellsAdded("CellsAdded");
+static const QString kSignalCellsRemoved("CellsRemoved");
+static const QString kCellInterface(OFONO_CELL_INTERFACE);
+static const QString kCellMethodGetAll("GetAll");
 
 typedef QMap<QString,QWeakPointer<QOfonoExtCellInfo> > QOfonoExtCellInfoMap;
 Q_GLOBAL_STATIC(QOfonoExtCellInfoMap, sharedInstances)
 
-// ==========================================================================
-// QOfonoExtCellInfoProxy
-//
-// qdbusxml2cpp doesn't really do much, and has a number of limitations,
-// such as the limits on number of arguments for QDBusPendingReply template.
-// It's easier to write these proxies by hand.
-// ==========================================================================
-
-class QOfonoExtCellInfoProxy: public QDBusAbstractInterface
-{
-    Q_OBJECT
-public:
-    static const QString INTERFACE;
-    QOfonoExtCellInfoProxy(QString aPath, QObject* aParent) :
-        QDBusAbstractInterface(OFONO_SERVICE, aPath, qPrintable(INTERFACE),
-            OFONO_BUS, aParent) {}
-
-public Q_SLOTS: // METHODS
-    QDBusPendingCall GetCellsAsync()
-        { return asyncCall(kMethodGetCells); }
-    QDBusMessage GetCellsSync()
-        { return call(kMethodGetCells); }
-
-Q_SIGNALS: // SIGNALS
-    void CellsAdded(QList<QDBusObjectPath> aPaths);
-    void CellsRemoved(QList<QDBusObjectPath> aPaths);
-};
-
-const QString QOfonoExtCellInfoProxy::INTERFACE("org.nemomobile.ofono.CellInfo");
-
 // ==========================================================================
 // QOfonoExtCellInfo::Private
 // ==========================================================================
@@ -63,9 +40,12 @@ class QOfonoExtCellInfo::Private : public QObject
 
 public:
     Private(QOfonoExtCellInfo* aParent);
+    ~Private();
+
     QString modemPath() const;
     void setModemPath(QString aPath);
     void setModemPathSyncInit(QString aPath);
+    void requestSnapshot();
 
 private:
     void getCellsSyncInit();
@@ -74,9 +54,15 @@ private:
     void setModemPath(QString aPath, QSharedPointer<QOfonoModem> aModem, void (Private::*aGetCells)());
     void checkInterfacePresence(void (Private::*getCellsFn)());
     static QStringList getPaths(const QList<QDBusObjectPath> aPaths);
+    void setCells(const QStringList& aCells);
+    void startSnapshot();
+    void snapshotCall(int aIndex);
+    void cancelSnapshot();
 
 private Q_SLOTS:
     void onModemChanged();
+    void onSnapshotCallFinished(QDBusPendingCallWatcher* aWatcher);
+    void finishSnapshot();
     void onGetCellsFinished(QDBusPendingCallWatcher* aWatcher);
     void onCellsAdded(QList<QDBusObjectPath> aCells);
     void onCellsRemoved(QList<QDBusObjectPath> aCells);
@@ -84,12 +70,20 @@ private Q_SLOTS:
 public:
     bool iValid;
     bool iFixedPath;
-    QStringList iCells;
+    QStringList iCells; // Sorted
+    QSet<QString> iCellSet;
+    QVector<QOfonoExtCellData> iSnapshot;
 
 private:
     QOfonoExtCellInfo* iParent;
-    QOfonoExtCellInfoProxy* iProxy;
+    QOfonoExtProxy* iProxy;
     QSharedPointer<QOfonoModem> iModem;
+    bool iSnapshotRequested;
+    QHash<QDBusPendingCallWatcher*,int> iSnapshotCalls;
+    QHash<int,QOfonoExtRetry*> iSnapshotRetries;
+    int iSnapshotPending;
+    QOfonoExtRetry iRetry;
+    QVector<QOfonoExtCellData> iPendingSnapshot;
 };
 
 QOfonoExtCellInfo::Private::Private(QOfonoExtCellInfo* aParent) :
@@ -97,10 +91,17 @@ QOfonoExtCellInfo::Private::Private(QOfonoExtCellInfo* aParent) :
     iValid(false),
     iFixedPath(false),
     iParent(aParent),
-    iProxy(NULL)
+    iProxy(NULL),
+    iSnapshotRequested(false),
+    iSnapshotPending(0)
 {
 }
 
+QOfonoExtCellInfo::Private::~Private()
+{
+    qDeleteAll(iSnapshotRetries);
+}
+
 inline QString QOfonoExtCellInfo::Private::modemPath() const
 {
     return iModem.isNull() ? QString() : iModem->objectPath();
@@ -141,23 +142,23 @@ void QOfonoExtCellInfo::Private::setModemPath(QString aPath,
 
 void QOfonoExtCellInfo::Private::getCellsAsync()
 {
-    connect(new QDBusPendingCallWatcher(iProxy->GetCellsAsync(), iProxy),
+    connect(new QDBusPendingCallWatcher(iProxy->asyncCall(kMethodGetCells), iProxy),
         SIGNAL(finished(QDBusPendingCallWatcher*)),
         SLOT(onGetCellsFinished(QDBusPendingCallWatcher*)));
 }
 
 void QOfonoExtCellInfo::Private::getCellsSyncInit()
 {
-    QDBusPendingReply<QList<QDBusObjectPath> > reply(iProxy->GetCellsSync());
+    QDBusPendingReply<QList<QDBusObjectPath> > reply(iProxy->call(kMethodGetCells));
     if (!reply.isError()) {
-        iCells = getPaths(reply.value());
+        setCells(getPaths(reply.value()));
         iValid = true;
     } else {
         // Repeat call asynchronously on timeout
         QDBusError error(reply.error());
         qWarning() << error;
         if (QOfonoExt::isTimeout(error)) {
-            getCellsAsync();
+            iRetry.schedule([this]() { getCellsAsync(); });
         }
     }
 }
@@ -165,16 +166,13 @@ void QOfonoExtCellInfo::Private::getCellsSyncInit()
 void QOfonoExtCellInfo::Private::checkInterfacePresence(void (Private::*aGetCells)())
 {
     if (iModem && iModem->isValid() &&
-        iModem->interfaces().contains(QOfonoExtCellInfoProxy::INTERFACE)) {
+        iModem->interfaces().contains(kInterface)) {
         if (!iProxy) {
-            iProxy = new QOfonoExtCellInfoProxy(iModem->objectPath(), this);
-            if (iProxy->isValid()) {
-                connect(iProxy,
-                    SIGNAL(CellsAdded(QList<QDBusObjectPath>)),
-                    SLOT(onCellsAdded(QList<QDBusObjectPath>)));
-                connect(iProxy,
-                    SIGNAL(CellsRemoved(QList<QDBusObjectPath>)),
-                    SLOT(onCellsRemoved(QList<QDBusObjectPath>)));
+            iProxy = new QOfonoExtProxy(iModem->objectPath(), kInterface, this);
+            if (iProxy->connectSignal(kSignalCellsAdded, this,
+                    SLOT(onCellsAdded(QList<QDBusObjectPath>))) &&
+                iProxy->connectSignal(kSignalCellsRemoved, this,
+                    SLOT(onCellsRemoved(QList<QDBusObjectPath>)))) {
                 (this->*aGetCells)();
             } else {
                 invalidate();
@@ -187,10 +185,16 @@ void QOfonoExtCellInfo::Private::checkInterfacePresence(void (Private::*aGetCell
 
 void QOfonoExtCellInfo::Private::invalidate()
 {
+    iRetry.cancel();
     if (iProxy) {
         delete iProxy;
         iProxy = NULL;
     }
+    if (iSnapshotPending) {
+        // Restart the snapshot when we become valid again
+        cancelSnapshot();
+        iSnapshotRequested = true;
+    }
     if (iValid) {
         iValid = false;
         Q_EMIT iParent->validChanged();
@@ -208,6 +212,16 @@ QStringList QOfonoExtCellInfo::Private::getPaths(const QList<QDBusObjectPath> aP
     return list;
 }
 
+void QOfonoExtCellInfo::Private::setCells(const QStringList& aCells)
+{
+    iCells = aCells;
+    iCellSet.clear();
+    iCellSet.reserve(aCells.count());
+    for (int i = 0; i < aCells.count(); i++) {
+        iCellSet.insert(aCells.at(i));
+    }
+}
+
 void QOfonoExtCellInfo::Private::onGetCellsFinished(QDBusPendingCallWatcher* aWatcher)
 {
     QDBusPendingReply<QList<QDBusObjectPath> > reply(*aWatcher);
@@ -216,18 +230,45 @@ void QOfonoExtCellInfo::Private::onGetCellsFinished(QDBusPendingCallWatcher* aWa
         QDBusError error(reply.error());
         qWarning() << error;
         if (QOfonoExt::isTimeout(error)) {
-            getCellsAsync();
+            iRetry.schedule([this]() { getCellsAsync(); });
+        } else {
+            iRetry.finished(false);
         }
     } else {
+        iRetry.finished(true);
         const QStringList list(getPaths(reply.value()));
         if (iCells != list) {
-            iCells = list;
+            // Both lists are sorted, merge them to find the differences
+            QStringList added, removed;
+            const int n1 = iCells.count();
+            const int n2 = list.count();
+            int i1 = 0, i2 = 0;
+            while (i1 < n1 || i2 < n2) {
+                if (i2 == n2 || (i1 < n1 && iCells.at(i1) < list.at(i2))) {
+                    removed.append(iCells.at(i1++));
+                } else if (i1 == n1 || list.at(i2) < iCells.at(i1)) {
+                    added.append(list.at(i2++));
+                } else {
+                    i1++;
+                    i2++;
+                }
+            }
+            setCells(list);
+            if (!removed.isEmpty()) {
+                Q_EMIT iParent->cellsRemoved(removed);
+            }
+            if (!added.isEmpty()) {
+                Q_EMIT iParent->cellsAdded(added);
+            }
             Q_EMIT iParent->cellsChanged();
         }
         if (!iValid) {
             iValid = true;
             Q_EMIT iParent->validChanged();
         }
+        if (iSnapshotRequested) {
+            startSnapshot();
+        }
     }
     aWatcher->deleteLater();
 }
@@ -242,13 +283,14 @@ void QOfonoExtCellInfo::Private::onCellsAdded(QList<QDBusObjectPath> aCells)
     QStringList cells;
     for (int i=0; i<aCells.count(); i++) {
         QString path = aCells.at(i).path();
-        if (!iCells.contains(path)) {
-            iCells.append(path);
+        if (!iCellSet.contains(path)) {
+            // Keep the list sorted
+            iCellSet.insert(path);
+            iCells.insert(std::lower_bound(iCells.begin(), iCells.end(), path), path);
             cells.append(path);
         }
     }
     if (!cells.isEmpty()) {
-        iCells.sort();
         Q_EMIT iParent->cellsAdded(cells);
         Q_EMIT iParent->cellsChanged();
     }
@@ -259,7 +301,8 @@ void QOfonoExtCellInfo::Private::onCellsRemoved(QList<QDBusObjectPath> aCells)
     QStringList cells;
     for (int i=0; i<aCells.count(); i++) {
         QString path = aCells.at(i).path();
-        if (iCells.removeOne(path)) {
+        if (iCellSet.remove(path)) {
+            iCells.erase(std::lower_bound(iCells.begin(), iCells.end(), path));
             cells.append(path);
         }
     }
@@ -269,6 +312,107 @@ void QOfonoExtCellInfo::Private::onCellsRemoved(QList<QDBusObjectPath> aCells)
     }
 }
 
+void QOfonoExtCellInfo::Private::requestSnapshot()
+{
+    // A newer request supersedes the pending one
+    cancelSnapshot();
+    if (iValid) {
+        startSnapshot();
+    } else {
+        iSnapshotRequested = true;
+    }
+}
+
+void QOfonoExtCellInfo::Private::startSnapshot()
+{
+    const int n = iCells.count();
+
+    // Don't wait for each reply before sending the next call, all
+    // GetAll calls are in flight at the same time
+    iSnapshotRequested = false;
+    iSnapshotPending = n;
+    iPendingSnapshot.resize(n);
+    for (int i=0; i<n; i++) {
+        iPendingSnapshot[i] = QOfonoExtCellData(new QOfonoExtCellData::Private(iCells.at(i)));
+        snapshotCall(i);
+    }
+    if (!n) {
+        QMetaObject::invokeMethod(this, "finishSnapshot", Qt::QueuedConnection);
+    }
+}
+
+void QOfonoExtCellInfo::Private::snapshotCall(int aIndex)
+{
+    const QDBusMessage call(QDBusMessage::createMethodCall(OFONO_SERVICE,
+        iPendingSnapshot.at(aIndex).iPrivate->iPath, kCellInterface,
+        kCellMethodGetAll));
+    QDBusPendingCallWatcher* watcher =
+        new QDBusPendingCallWatcher(OFONO_BUS.asyncCall(call), this);
+    iSnapshotCalls.insert(watcher, aIndex);
+    connect(watcher,
+        SIGNAL(finished(QDBusPendingCallWatcher*)),
+        SLOT(onSnapshotCallFinished(QDBusPendingCallWatcher*)));
+}
+
+void QOfonoExtCellInfo::Private::cancelSnapshot()
+{
+    qDeleteAll(iSnapshotCalls.keys());
+    iSnapshotCalls.clear();
+    qDeleteAll(iSnapshotRetries);
+    iSnapshotRetries.clear();
+    iSnapshotPending = 0;
+    iPendingSnapshot.clear();
+    iSnapshotRequested = false;
+}
+
+void QOfonoExtCellInfo::Private::onSnapshotCallFinished(QDBusPendingCallWatcher* aWatcher)
+{
+    const int index = iSnapshotCalls.take(aWatcher);
+    QOfonoExtCellData::Private::GetAllReply reply(*aWatcher);
+    QOfonoExtRetry* retry = iSnapshotRetries.value(index);
+
+    aWatcher->deleteLater();
+    if (reply.isError()) {
+        const QDBusError error(reply.error());
+        qWarning() << error;
+        if (QOfonoExt::isTimeout(error)) {
+            // Retries are created on demand, most snapshots don't need any
+            if (!retry) {
+                retry = new QOfonoExtRetry;
+                iSnapshotRetries.insert(index, retry);
+            }
+            retry->schedule([this,index]() { snapshotCall(index); });
+            return;
+        }
+        // The cell is left invalid and gets dropped from the snapshot
+        if (retry) retry->finished(false);
+    } else {
+        if (retry) retry->finished(true);
+        iPendingSnapshot[index].iPrivate->setGetAllReply(reply);
+    }
+    if (!--iSnapshotPending) {
+        finishSnapshot();
+    }
+}
+
+void QOfonoExtCellInfo::Private::finishSnapshot()
+{
+    if (!iSnapshotPending && !iSnapshotRequested) {
+        qDeleteAll(iSnapshotRetries);
+        iSnapshotRetries.clear();
+        iSnapshot.resize(0);
+        iSnapshot.reserve(iPendingSnapshot.count());
+        for (int i=0; i<iPendingSnapshot.count(); i++) {
+            const QOfonoExtCellData& data(iPendingSnapshot.at(i));
+            if (data.isValid()) {
+                iSnapshot.append(data);
+            }
+        }
+        iPendingSnapshot.clear();
+        Q_EMIT iParent->snapshotReady();
+    }
+}
+
 // ==========================================================================
 // QOfonoExtCellInfo
 // ==========================================================================
@@ -318,6 +462,11 @@ bool QOfonoExtCellInfo::valid() const
     return iPrivate->iValid;
 }
 
+void QOfonoExtCellInfo::whenValid(QObject* aContext, std::function<void()> aCallback) // Since 1.0.33
+{
+    QOfonoExt::whenValid(this, &QOfonoExtCellInfo::validChanged, aContext, aCallback);
+}
+
 QString QOfonoExtCellInfo::modemPath() const
 {
     return iPrivate->modemPath();
@@ -328,6 +477,21 @@ QStringList QOfonoExtCellInfo::cells() const
     return iPrivate->iCells;
 }
 
+bool QOfonoExtCellInfo::containsCell(QString aPath) const // Since 1.0.33
+{
+    return iPrivate->iCellSet.contains(aPath);
+}
+
+void QOfonoExtCellInfo::requestSnapshot() // Since 1.0.33
+{
+    iPrivate->requestSnapshot();
+}
+
+QVector<QOfonoExtCellData> QOfonoExtCellInfo::snapshot() const // Since 1.0.33
+{
+    return iPrivate->iSnapshot;
+}
+
 void QOfonoExtCellInfo::setModemPath(QString aModemPath)
 {
     if (iPrivate->modemPath() != aModemPath) {
@@ -16,7 +16,7 @@
 #ifndef QOFONOEXTCELLINFO_H
 #define QOFONOEXTCELLINFO_H
 
-#include "qofonoext_types.h"
+#include "qofonoextcelldata.h"
 
 class QOFONOEXT_EXPORT QOfonoExtCellInfo : public QObject
 {
@@ -27,7 +27,7 @@ class QOFONOEXT_EXPORT QOfonoExtCellInfo : public QObject
 
 public:
     explicit QOfonoExtCellInfo(QObject* aParent = Q_NULLPTR);
-    QOfonoExtCellInfo(QString aModemPath, QObject* aParent = Q_NULLPTR); // Blocks (since 1.0.27)
+    QOfonoExtCellInfo(QString aModemPath, QObject* aParent = Q_NULLPTR); // Blocks (since 1.0.27), see whenValid()
     ~QOfonoExtCellInfo();
 
     // Shared instance(s) for C++ use
@@ -39,6 +39,19 @@ public:
 
     bool valid() const;
     QStringList cells() const;
+    bool containsCell(QString aPath) const; // Since 1.0.33, O(1)
+
+    // Non-blocking alternative to the blocking constructor. Invokes
+    // the callback when the object becomes valid (or right away if it
+    // already is), unless aContext gets destroyed first. Since 1.0.33
+    void whenValid(QObject* aContext, std::function<void()> aCallback);
+
+    // Fetches the state of all cells with one batch of pipelined
+    // calls and emits snapshotReady() when they all have completed.
+    // Timed out calls are retried like the rest of the init calls.
+    // Since 1.0.33
+    void requestSnapshot();
+    QVector<QOfonoExtCellData> snapshot() const;
 
 Q_SIGNALS:
     void validChanged();
@@ -46,6 +59,7 @@ Q_SIGNALS:
     void cellsChanged();
     void cellsAdded(QStringList cells);
     void cellsRemoved(QStringList cells);
+    void snapshotReady(); // Since 1.0.33
 
 private:
     class Private;
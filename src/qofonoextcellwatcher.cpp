@@ -21,34 +21,55 @@ class QOfonoExtCellWatcher::Private : public QObject {
     Q_OBJECT
 
 public:
+    typedef QSharedPointer<QOfonoExtCell> CellPtr;
+
+    struct Entry {
+        Entry() : valid(false), published(false) {}
+        CellPtr cell;
+        bool valid;
+        bool published;
+    };
+
     Private(QOfonoExtCellWatcher* aParent);
 
     QOfonoExtCellWatcher* iParent;
     QSharedPointer<QOfonoManager> iOfonoManager;
     QList<QSharedPointer<QOfonoExtCellInfo> > iCellInfoList;
-    QList<QSharedPointer<QOfonoExtCell> > iValidCells;
-    QMap<QString, QSharedPointer<QOfonoExtCell> > iKnownCells;
+    QList<CellPtr> iValidCells;
+    QMap<QString, Entry> iKnownCells;
+    QList<CellPtr> iAddedCells;
+    QList<CellPtr> iRemovedCells;
+    int iInvalidCount;
 
 private:
-    void updateCellInfo();
-    QStringList updateKnownCells();
+    void addCells(const QStringList& aPaths);
+    void removeCells(const QStringList& aPaths);
+    void removeModemCells(const QString& aModemPath);
+    void publish();
 
 public Q_SLOTS:
-    void updateValidCells();
+    void updateCellInfo();
+
+private Q_SLOTS:
+    void onCellsAdded(QStringList aPaths);
+    void onCellsRemoved(QStringList aPaths);
+    void onCellValidChanged();
+    void onCellChanged();
 };
 
 QOfonoExtCellWatcher::Private::Private(QOfonoExtCellWatcher* aParent) :
     QObject(aParent),
     iParent(aParent),
-    iOfonoManager(QOfonoManager::instance())
+    iOfonoManager(QOfonoManager::instance()),
+    iInvalidCount(0)
 {
     connect(iOfonoManager.data(),
         SIGNAL(availableChanged(bool)),
-        SLOT(updateValidCells()));
+        SLOT(updateCellInfo()));
     connect(iOfonoManager.data(),
         SIGNAL(modemsChanged(QStringList)),
-        SLOT(updateValidCells()));
-    updateValidCells();
+        SLOT(updateCellInfo()));
+    updateCellInfo();
 }
 
 void QOfonoExtCellWatcher::Private::updateCellInfo()
@@ -71,92 +92,170 @@ void QOfonoExtCellWatcher::Private::updateCellInfo()
     }
     if (changed) {
         QList<QSharedPointer<QOfonoExtCellInfo> > bak(iCellInfoList);
-        for (i=0; i<iCellInfoList.count(); i++) {
-            iCellInfoList.at(i)->disconnect(this);
-        }
         iCellInfoList.clear();
         for (i=0; i<modems.count(); i++) {
-            QSharedPointer<QOfonoExtCellInfo> cellInfo =
-                QOfonoExtCellInfo::instance(modems.at(i));
+            const QString path(modems.at(i));
+            QSharedPointer<QOfonoExtCellInfo> cellInfo;
+            for (int k=0; k<bak.count(); k++) {
+                if (bak.at(k)->modemPath() == path) {
+                    cellInfo = bak.takeAt(k);
+                    break;
+                }
+            }
+            if (cellInfo.isNull()) {
+                // This is the first time we are seeing this modem
+                cellInfo = QOfonoExtCellInfo::instance(path);
+                connect(cellInfo.data(),
+                    SIGNAL(cellsAdded(QStringList)),
+                    SLOT(onCellsAdded(QStringList)));
+                connect(cellInfo.data(),
+                    SIGNAL(cellsRemoved(QStringList)),
+                    SLOT(onCellsRemoved(QStringList)));
+                addCells(cellInfo->cells());
+            }
             iCellInfoList.append(cellInfo);
-            connect(cellInfo.data(),
-                SIGNAL(cellsChanged()),
-                SLOT(updateValidCells()));
         }
+        // Drop the cells of the modems that are gone
+        for (i=0; i<bak.count(); i++) {
+            bak.at(i)->disconnect(this);
+            removeModemCells(bak.at(i)->modemPath());
+        }
+        publish();
     }
 }
 
-QStringList QOfonoExtCellWatcher::Private::updateKnownCells()
+void QOfonoExtCellWatcher::Private::addCells(const QStringList& aPaths)
 {
-    updateCellInfo();
-
-    QStringList allCells;
-    int i;
-    for (i=0; i<iCellInfoList.count(); i++) {
-        allCells.append(iCellInfoList.at(i)->cells());
+    for (int i=0; i<aPaths.count(); i++) {
+        const QString path(aPaths.at(i));
+        if (!iKnownCells.contains(path)) {
+            Entry entry;
+            entry.cell = CellPtr(new QOfonoExtCell(path), &QObject::deleteLater);
+            entry.valid = entry.cell->valid();
+            if (!entry.valid) {
+                iInvalidCount++;
+            }
+            connect(entry.cell.data(),
+                SIGNAL(validChanged()),
+                SLOT(onCellValidChanged()));
+            connect(entry.cell.data(),
+                SIGNAL(changed(quint64)),
+                SLOT(onCellChanged()));
+            iKnownCells.insert(path, entry);
+            iAddedCells.append(entry.cell);
+        }
     }
+}
 
-    QStringList knownCells(iKnownCells.keys());
-    allCells.sort();
-    knownCells.sort();
-    if (allCells != knownCells) {
-        QMap<QString, QSharedPointer<QOfonoExtCell> > bak(iKnownCells);
-        iKnownCells.clear();
-        for (i=0; i<allCells.count(); i++) {
-            QString path(allCells.at(i));
-            QSharedPointer<QOfonoExtCell> cell = bak.value(path);
-            if (cell.isNull()) {
-                cell = QSharedPointer<QOfonoExtCell>(new QOfonoExtCell(path), &QObject::deleteLater);
+void QOfonoExtCellWatcher::Private::removeCells(const QStringList& aPaths)
+{
+    for (int i=0; i<aPaths.count(); i++) {
+        QMap<QString, Entry>::iterator it = iKnownCells.find(aPaths.at(i));
+        if (it != iKnownCells.end()) {
+            const Entry entry(it.value());
+            iKnownCells.erase(it);
+            entry.cell->disconnect(this);
+            if (!entry.valid) {
+                iInvalidCount--;
             }
-            iKnownCells.insert(path, cell);
-            if (!bak.remove(path)) {
-                // This is the first time we are seeing this cell
-                connect(cell.data(),
-                    SIGNAL(validChanged()),
-                    SLOT(updateValidCells()));
+            if (entry.published) {
+                iRemovedCells.append(entry.cell);
+            } else {
+                // Added and removed before anyone has seen it
+                iAddedCells.removeOne(entry.cell);
             }
         }
-        // Disconnect those cells that we no longer need
-        QList<QSharedPointer<QOfonoExtCell> > leftover = bak.values();
-        for (i=0; i<leftover.count(); i++) {
-            leftover.at(i)->disconnect(this);
-        }
     }
+}
 
-    return allCells;
+void QOfonoExtCellWatcher::Private::removeModemCells(const QString& aModemPath)
+{
+    // Cell paths are prefixed with the modem path
+    const QString prefix(aModemPath + QLatin1Char('/'));
+    QStringList paths;
+    QMap<QString, Entry>::const_iterator it = iKnownCells.lowerBound(prefix);
+    while (it != iKnownCells.constEnd() && it.key().startsWith(prefix)) {
+        paths.append(it.key());
+        ++it;
+    }
+    removeCells(paths);
 }
 
-void QOfonoExtCellWatcher::Private::updateValidCells()
+void QOfonoExtCellWatcher::Private::publish()
 {
-    QStringList knownCells = updateKnownCells();
-    QStringList validCells;
-    int i;
-    for (i=0; i<knownCells.count(); i++) {
-        QString path(knownCells.at(i));
-        QSharedPointer<QOfonoExtCell> cell = iKnownCells.value(path);
-        if (cell->valid()) {
-            validCells.append(path);
+    // The list is only updated when all known cells are valid
+    if (!iInvalidCount && (!iAddedCells.isEmpty() || !iRemovedCells.isEmpty())) {
+        int i;
+        const QList<CellPtr> added(iAddedCells);
+        const QList<CellPtr> removed(iRemovedCells);
+        iAddedCells.clear();
+        iRemovedCells.clear();
+        for (i=0; i<added.count(); i++) {
+            iKnownCells[added.at(i)->path()].published = true;
         }
-    }
 
-    bool changed = true;
-    if (validCells.count() == iValidCells.count()) {
-        changed = false;
-        for (i=0; i<validCells.count(); i++) {
-            if (iValidCells.at(i)->path() != validCells.at(i)) {
-                changed = true;
-                break;
+        // No string comparisons here, the map is already sorted
+        iValidCells.clear();
+        iValidCells.reserve(iKnownCells.count());
+        QMap<QString, Entry>::const_iterator it = iKnownCells.constBegin();
+        for (; it != iKnownCells.constEnd(); ++it) {
+            iValidCells.append(it.value().cell);
+        }
+
+        if (iParent) {
+            for (i=0; i<removed.count() && iParent; i++) {
+                Q_EMIT iParent->cellRemoved(removed.at(i));
+            }
+            for (i=0; i<added.count() && iParent; i++) {
+                Q_EMIT iParent->cellAdded(added.at(i));
+            }
+            if (iParent) {
+                Q_EMIT iParent->cellsChanged();
             }
         }
     }
+}
 
-    if (changed && validCells.count() == knownCells.count()) {
-        iValidCells.clear();
-        for (i=0; i<validCells.count(); i++) {
-            iValidCells.append(iKnownCells.value(validCells.at(i)));
+void QOfonoExtCellWatcher::Private::onCellsAdded(QStringList aPaths)
+{
+    addCells(aPaths);
+    publish();
+}
+
+void QOfonoExtCellWatcher::Private::onCellsRemoved(QStringList aPaths)
+{
+    removeCells(aPaths);
+    publish();
+}
+
+void QOfonoExtCellWatcher::Private::onCellValidChanged()
+{
+    QOfonoExtCell* cell = qobject_cast<QOfonoExtCell*>(sender());
+    if (cell) {
+        QMap<QString, Entry>::iterator it = iKnownCells.find(cell->path());
+        if (it != iKnownCells.end()) {
+            Entry& entry = it.value();
+            const bool valid = cell->valid();
+            if (entry.valid != valid) {
+                entry.valid = valid;
+                if (valid) {
+                    iInvalidCount--;
+                    publish();
+                } else {
+                    iInvalidCount++;
+                }
+            }
         }
-        if (iParent) {
-            Q_EMIT iParent->cellsChanged();
+    }
+}
+
+void QOfonoExtCellWatcher::Private::onCellChanged()
+{
+    QOfonoExtCell* cell = qobject_cast<QOfonoExtCell*>(sender());
+    if (cell && iParent) {
+        QMap<QString, Entry>::const_iterator it = iKnownCells.constFind(cell->path());
+        if (it != iKnownCells.constEnd() && it.value().published) {
+            Q_EMIT iParent->cellUpdated(it.value().cell);
         }
     }
 }
@@ -178,4 +277,16 @@ QList<QSharedPointer<QOfonoExtCell> > QOfonoExtCellWatcher::cells() const
     return iPrivate->iValidCells;
 }
 
+QVector<QOfonoExtCellData> QOfonoExtCellWatcher::cellData() const // Since 1.0.33
+{
+    // Each element shares the state with its QOfonoExtCell, no deep copies
+    const int n = iPrivate->iValidCells.count();
+    QVector<QOfonoExtCellData> data;
+    data.reserve(n);
+    for (int i=0; i<n; i++) {
+        data.append(iPrivate->iValidCells.at(i)->data());
+    }
+    return data;
+}
+
 #include "qofonoextcellwatcher.moc"
@@ -16,7 +16,7 @@
 #ifndef QOFONOEXTCELLWATCHER_H
 #define QOFONOEXTCELLWATCHER_H
 
-#include "qofonoextcell.h"
+#include "qofonoextcelldata.h"
 
 // Watches available cells from all modems
 class QOFONOEXT_EXPORT QOfonoExtCellWatcher : public QObject
@@ -28,9 +28,13 @@ public:
     ~QOfonoExtCellWatcher();
 
     QList<QSharedPointer<QOfonoExtCell> > cells() const;
+    QVector<QOfonoExtCellData> cellData() const; // Since 1.0.33
 
 Q_SIGNALS:
     void cellsChanged();
+    void cellAdded(QSharedPointer<QOfonoExtCell> cell); // Since 1.0.33
+    void cellRemoved(QSharedPointer<QOfonoExtCell> cell); // Since 1.0.33
+    void cellUpdated(QSharedPointer<QOfonoExtCell> cell); // Since 1.0.33
 
 private:
     class Private;
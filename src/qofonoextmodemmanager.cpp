@@ -115,9 +115,19 @@ class QOfonoExtModemManager::Private : public QObject
     Q_OBJECT
     typedef QList<QOfonoExtModemManagerProxy::Error> ErrorList;
     typedef QList<ErrorList> ModemErrors;
+    typedef QSharedPointer<const QOfonoExtModemState> SharedState;
+
+    enum {
+        CacheMagic = 0x4d4d4743, // "MMGC"
+        CacheFormat = 1
+    };
+
+    // The newest interface version we know how to handle
+    enum { LatestInterfaceVersion = 8 };
 
 public:
     static QWeakPointer<QOfonoExtModemManager> sSharedInstance;
+    static QString sCacheFile;
 
     QOfonoExtModemManager* iParent;
     QOfonoExtModemManagerProxy* iProxy;
@@ -136,18 +146,32 @@ public:
     int iPresentSimCount;
     int iActiveSimCount;
     int iInterfaceVersion;
+    int iGetAllVersion;
+    bool iVersionConfirmed;
     bool iReady;
     bool iValid;
+    bool iStale;
     int iErrorCount;
+    QString iCacheFile;
+    QByteArray iCachedState;
+    ChangeFlags iChanges;
+    // See publishState() and sharedState()
+    QAtomicPointer<SharedState> iSharedState;
+    QAtomicInt iSharedStateReaders;
+    QList<SharedState*> iRetiredStates;
+    QOfonoExtRetry iRetry;
 
     Private(QOfonoExtModemManager* aParent);
+    ~Private();
 
     static QStringList toStringList(QList<QDBusObjectPath> aList);
     static QList<QDBusObjectPath> toPathList(QStringList aList);
     QStringList dummyStringList();
 
-    void getAll();
+    void getAll(int aVersion);
     void getInterfaceVersion();
+    void connectSignals(int aVersion);
+    void updateInterfaceVersion(int aVersion);
     void presentSimsChanged(QList<bool> aOldList);
     void updateSimCounts();
     void updateEnabledModems(QStringList aModems);
@@ -158,6 +182,13 @@ public:
     void updateMmsSim(QString aImsi);
     void updateMmsModem(QString aPath);
     void updateReady(bool aReady);
+    void updateStale(bool aStale);
+    void emitStateChanged();
+    QOfonoExtModemState currentState() const;
+    void publishState();
+    QByteArray cacheData() const;
+    void loadCache();
+    void saveCache();
 
 private Q_SLOTS:
     void onServiceRegistered();
@@ -177,6 +208,7 @@ private Q_SLOTS:
 };
 
 QWeakPointer<QOfonoExtModemManager> QOfonoExtModemManager::Private::sSharedInstance;
+QString QOfonoExtModemManager::Private::sCacheFile;
 
 QStringList QOfonoExtModemManager::Private::toStringList(QList<QDBusObjectPath> aList)
 {
@@ -205,13 +237,24 @@ QOfonoExtModemManager::Private::Private(QOfonoExtModemManager* aParent) :
     iPresentSimCount(0),
     iActiveSimCount(0),
     iInterfaceVersion(0),
+    iGetAllVersion(0),
+    iVersionConfirmed(false),
     iReady(false),
     iValid(false),
-    iErrorCount(0)
+    iStale(false),
+    iErrorCount(0),
+    iCacheFile(sCacheFile),
+    iSharedState(Q_NULLPTR)
 {
     qRegisterMetaType<QOfonoExtModemManagerProxy::Error>("QOfonoExtModemManagerProxy::Error");
     qDBusRegisterMetaType<QOfonoExtModemManagerProxy::Error>();
 
+    if (!iCacheFile.isEmpty()) {
+        loadCache();
+    }
+    iChanges = NoChange;
+    publishState();
+
     QDBusServiceWatcher* ofonoWatcher = new QDBusServiceWatcher(OFONO_SERVICE,
         OFONO_BUS, QDBusServiceWatcher::WatchForRegistration |
         QDBusServiceWatcher::WatchForUnregistration, this);
@@ -226,6 +269,101 @@ QOfonoExtModemManager::Private::Private(QOfonoExtModemManager* aParent) :
     }
 }
 
+QOfonoExtModemManager::Private::~Private()
+{
+    // Pick up the changes received after the last GetAll
+    if (iValid) {
+        saveCache();
+    }
+    // Nobody may be reading the snapshot by now
+    qDeleteAll(iRetiredStates);
+    delete iSharedState.loadAcquire();
+}
+
+QByteArray QOfonoExtModemManager::Private::cacheData() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << quint32(CacheMagic) << quint32(CacheFormat)
+        << qint32(iInterfaceVersion) << iAvailableModems << iEnabledModems
+        << iDefaultVoiceModem << iDefaultDataModem << iDefaultVoiceSim
+        << iDefaultDataSim << iPresentSims << iIMEIs << iIMEISVs
+        << iMmsSim << iMmsModem << iReady;
+    return data;
+}
+
+void QOfonoExtModemManager::Private::loadCache()
+{
+    QFile file(iCacheFile);
+    const qint64 size = file.size();
+    if (size > 0 && file.open(QIODevice::ReadOnly)) {
+        const uchar* map = file.map(0, size);
+        if (map) {
+            // Parse straight from the mapped file, without reading it
+            const QByteArray data(QByteArray::fromRawData((const char*)map, size));
+            QDataStream in(data);
+            in.setVersion(QDataStream::Qt_5_0);
+            quint32 magic = 0, format = 0;
+            in >> magic >> format;
+            if (magic == CacheMagic && format == CacheFormat) {
+                qint32 version = 0;
+                QStringList availableModems, enabledModems, imeis, imeisvs;
+                QString defaultVoiceModem, defaultDataModem;
+                QString defaultVoiceSim, defaultDataSim;
+                QString mmsSim, mmsModem;
+                QList<bool> presentSims;
+                bool ready = false;
+                in >> version >> availableModems >> enabledModems
+                    >> defaultVoiceModem >> defaultDataModem >> defaultVoiceSim
+                    >> defaultDataSim >> presentSims >> imeis >> imeisvs
+                    >> mmsSim >> mmsModem >> ready;
+                if (in.status() == QDataStream::Ok) {
+                    // Nothing is connected to the signals yet
+                    iInterfaceVersion = version;
+                    iAvailableModems = availableModems;
+                    iEnabledModems = enabledModems;
+                    iDefaultVoiceModem = defaultVoiceModem;
+                    iDefaultDataModem = defaultDataModem;
+                    iDefaultVoiceSim = defaultVoiceSim;
+                    iDefaultDataSim = defaultDataSim;
+                    iPresentSims = presentSims;
+                    iIMEIs = imeis;
+                    iIMEISVs = imeisvs;
+                    iMmsSim = mmsSim;
+                    iMmsModem = mmsModem;
+                    iReady = ready;
+                    iStale = true;
+                    updateSimCounts();
+                    iCachedState = QByteArray(data.constData(), data.size());
+                }
+            }
+            file.unmap((uchar*)map);
+        }
+    }
+}
+
+void QOfonoExtModemManager::Private::saveCache()
+{
+    if (!iCacheFile.isEmpty()) {
+        const QByteArray data(cacheData());
+        if (iCachedState != data) {
+            QDir().mkpath(QFileInfo(iCacheFile).absolutePath());
+            QSaveFile file(iCacheFile);
+            // IMEIs and IMSIs are nobody else's business. QSaveFile would
+            // carry over the permissions of an existing file otherwise.
+            if (file.open(QIODevice::WriteOnly) &&
+                file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner) &&
+                file.write(data) == data.size() &&
+                file.commit()) {
+                iCachedState = data;
+            } else {
+                qWarning() << "Failed to write" << iCacheFile;
+            }
+        }
+    }
+}
+
 void QOfonoExtModemManager::Private::onServiceRegistered()
 {
     const bool wasValid = iValid;
@@ -251,19 +389,30 @@ void QOfonoExtModemManager::Private::onServiceRegistered()
             connect(iProxy,
                 SIGNAL(PresentSimsChanged(int,bool)),
                 SLOT(onPresentSimsChanged(int,bool)));
-            getInterfaceVersion();
+            // Skip the GetInterfaceVersion round trip and go straight
+            // for the version we have seen last time (or the newest one).
+            // If ofono doesn't support it, we will find out the hard way.
+            const int version = iInterfaceVersion ?
+                qMin((int)iInterfaceVersion, (int)LatestInterfaceVersion) :
+                LatestInterfaceVersion;
+            iVersionConfirmed = false;
+            connectSignals(version);
+            getAll(version);
         } else {
             delete iProxy;
             iProxy = NULL;
         }
     }
     if (wasValid != iValid) {
+        iChanges |= ValidChange;
         Q_EMIT iParent->validChanged(iValid);
     }
+    emitStateChanged();
 }
 
 void QOfonoExtModemManager::Private::onServiceUnregistered()
 {
+    iRetry.cancel();
     if (iProxy) {
         // iProxy is the parent of iInitCall
         iInitCall = NULL;
@@ -272,8 +421,10 @@ void QOfonoExtModemManager::Private::onServiceUnregistered()
     }
     if (iValid) {
         iValid = false;
+        iChanges |= ValidChange;
         Q_EMIT iParent->validChanged(iValid);
     }
+    emitStateChanged();
 }
 
 void QOfonoExtModemManager::Private::getInterfaceVersion()
@@ -283,20 +434,57 @@ void QOfonoExtModemManager::Private::getInterfaceVersion()
         SLOT(onGetInterfaceVersionFinished(QDBusPendingCallWatcher*)));
 }
 
-void QOfonoExtModemManager::Private::getAll()
+void QOfonoExtModemManager::Private::getAll(int aVersion)
 {
+    iGetAllVersion = aVersion;
     iInitCall = new QDBusPendingCallWatcher(
-        (iInterfaceVersion == 2) ? QDBusPendingCall(iProxy->GetAll2()) :
-        (iInterfaceVersion == 3) ? QDBusPendingCall(iProxy->GetAll3()) :
-        (iInterfaceVersion == 4) ? QDBusPendingCall(iProxy->GetAll4()) :
-        (iInterfaceVersion == 5) ? QDBusPendingCall(iProxy->GetAll5()) :
-        (iInterfaceVersion == 6) ? QDBusPendingCall(iProxy->GetAll6()) :
-        (iInterfaceVersion == 7) ? QDBusPendingCall(iProxy->GetAll7()) :
+        (aVersion <= 1) ? QDBusPendingCall(iProxy->GetAll()) :
+        (aVersion == 2) ? QDBusPendingCall(iProxy->GetAll2()) :
+        (aVersion == 3) ? QDBusPendingCall(iProxy->GetAll3()) :
+        (aVersion == 4) ? QDBusPendingCall(iProxy->GetAll4()) :
+        (aVersion == 5) ? QDBusPendingCall(iProxy->GetAll5()) :
+        (aVersion == 6) ? QDBusPendingCall(iProxy->GetAll6()) :
+        (aVersion == 7) ? QDBusPendingCall(iProxy->GetAll7()) :
         QDBusPendingCall(iProxy->GetAll8()), iProxy);
     connect(iInitCall, SIGNAL(finished(QDBusPendingCallWatcher*)),
         SLOT(onGetAllFinished(QDBusPendingCallWatcher*)));
 }
 
+void QOfonoExtModemManager::Private::connectSignals(int aVersion)
+{
+    // Make sure we don't connect signals more than once
+    if (aVersion > iProxy->iInterfaceVersion) {
+        if (aVersion >= 4 && iProxy->iInterfaceVersion < 4) {
+            connect(iProxy,
+                SIGNAL(MmsSimChanged(QString)),
+                SLOT(onMmsSimChanged(QString)));
+            connect(iProxy,
+                SIGNAL(MmsModemChanged(QString)),
+                SLOT(onMmsModemChanged(QString)));
+        }
+        if (aVersion >= 5 && iProxy->iInterfaceVersion < 5) {
+            connect(iProxy,
+                SIGNAL(ReadyChanged(bool)),
+                SLOT(onReadyChanged(bool)));
+        }
+        if (aVersion >= 6 && iProxy->iInterfaceVersion < 6) {
+            connect(iProxy,
+                SIGNAL(ModemError(QDBusObjectPath,QString,QString)),
+                SLOT(onModemError(QDBusObjectPath,QString,QString)));
+        }
+        iProxy->iInterfaceVersion = aVersion;
+    }
+}
+
+void QOfonoExtModemManager::Private::updateInterfaceVersion(int aVersion)
+{
+    if (iInterfaceVersion != aVersion) {
+        iInterfaceVersion = aVersion;
+        iChanges |= InterfaceVersionChange;
+        Q_EMIT iParent->interfaceVersionChanged(aVersion);
+    }
+}
+
 void QOfonoExtModemManager::Private::onGetInterfaceVersionFinished(QDBusPendingCallWatcher* aWatcher)
 {
     QDBusPendingReply<int> reply(*aWatcher);
@@ -305,38 +493,19 @@ void QOfonoExtModemManager::Private::onGetInterfaceVersionFinished(QDBusPendingC
         // Repeat the call on timeout
         qWarning() << reply.error();
         if (QOfonoExt::isTimeout(reply.error())) {
-            getInterfaceVersion();
+            iRetry.schedule([this]() { getInterfaceVersion(); });
+        } else {
+            iRetry.finished(false);
         }
     } else {
+        iRetry.finished(true);
         const int version = reply.value();
-        // Make sure we don't connect signals more than once
-        if (version > iProxy->iInterfaceVersion) {
-            if (version >= 4 && iProxy->iInterfaceVersion < 4) {
-                connect(iProxy,
-                    SIGNAL(MmsSimChanged(QString)),
-                    SLOT(onMmsSimChanged(QString)));
-                connect(iProxy,
-                    SIGNAL(MmsModemChanged(QString)),
-                    SLOT(onMmsModemChanged(QString)));
-            }
-            if (version >= 5 && iProxy->iInterfaceVersion < 5) {
-                connect(iProxy,
-                    SIGNAL(ReadyChanged(bool)),
-                    SLOT(onReadyChanged(bool)));
-            }
-            if (version >= 6 && iProxy->iInterfaceVersion < 6) {
-                connect(iProxy,
-                    SIGNAL(ModemError(QDBusObjectPath,QString,QString)),
-                    SLOT(onModemError(QDBusObjectPath,QString,QString)));
-            }
-            iProxy->iInterfaceVersion = version;
-        }
-        if (iInterfaceVersion != version) {
-            iInterfaceVersion = version;
-            iParent->interfaceVersionChanged(version);
-        }
-        getAll();
+        iVersionConfirmed = true;
+        connectSignals(version);
+        updateInterfaceVersion(version);
+        getAll(qMin(version, (int)LatestInterfaceVersion));
     }
+    emitStateChanged();
     aWatcher->deleteLater();
 }
 
@@ -353,16 +522,42 @@ void QOfonoExtModemManager::Private::onGetAllFinished(QDBusPendingCallWatcher* a
         reply(*aWatcher);
     iInitCall = NULL;
     if (reply.isError()) {
-        // Repeat the call on timeout
-        qWarning() << reply.error();
-        if (QOfonoExt::isTimeout(reply.error())) {
-            getAll();
+        const QDBusError error(reply.error());
+        if (error.type() == QDBusError::UnknownMethod && !iVersionConfirmed) {
+            // We have guessed wrong, ask ofono what it supports
+            iRetry.finished(false);
+            getInterfaceVersion();
+        } else {
+            // Repeat the call on timeout
+            qWarning() << error;
+            if (QOfonoExt::isTimeout(error)) {
+                const int version = iGetAllVersion;
+                iRetry.schedule([this, version]() { getAll(version); });
+            } else {
+                iRetry.finished(false);
+            }
         }
-    } else {
+    } else if (reply.argumentAt<0>() > iGetAllVersion &&
+        iGetAllVersion < LatestInterfaceVersion) {
+        // Ofono has been upgraded since we have cached the version,
+        // the reply is missing something. Ask again.
         const int version = reply.argumentAt<0>();
+        iRetry.finished(true);
+        iVersionConfirmed = true;
+        connectSignals(version);
+        updateInterfaceVersion(version);
+        getAll(qMin(version, (int)LatestInterfaceVersion));
+    } else {
+        // Only parse what this GetAll variant actually returns
+        const int version = qMin(reply.argumentAt<0>(), iGetAllVersion);
+        iRetry.finished(true);
+        iVersionConfirmed = true;
+        connectSignals(version);
+        updateInterfaceVersion(reply.argumentAt<0>());
         QStringList list = toStringList(reply.argumentAt<1>());
         if (iAvailableModems != list) {
             iAvailableModems = list;
+            iChanges |= AvailableModemsChange;
             Q_EMIT iParent->availableModemsChanged(iAvailableModems);
         }
         updateEnabledModems(toStringList(reply.argumentAt<2>()));
@@ -384,6 +579,7 @@ void QOfonoExtModemManager::Private::onGetAllFinished(QDBusPendingCallWatcher* a
 
         if (iIMEIs != list) {
             iIMEIs = list;
+            iChanges |= ImeiCodesChange;
             Q_EMIT iParent->imeiCodesChanged(iIMEIs);
         }
 
@@ -434,19 +630,25 @@ void QOfonoExtModemManager::Private::onGetAllFinished(QDBusPendingCallWatcher* a
 
         if (iErrorCount != errorCount) {
             iErrorCount = errorCount;
+            iChanges |= ErrorCountChange;
             Q_EMIT iParent->errorCountChanged(errorCount);
         }
 
         if (iIMEISVs != list) {
             iIMEISVs = list;
+            iChanges |= ImeisvCodesChange;
             Q_EMIT iParent->imeisvCodesChanged(iIMEISVs);
         }
 
+        saveCache();
+        updateStale(false);
         if (!iValid) {
             iValid = true;
+            iChanges |= ValidChange;
             Q_EMIT iParent->validChanged(iValid);
         }
     }
+    emitStateChanged();
     aWatcher->deleteLater();
 }
 
@@ -473,10 +675,12 @@ void QOfonoExtModemManager::Private::presentSimsChanged(QList<bool> aOldList)
     updateSimCounts();
     for (i=0; i<n; i++) {
         if (changed.at(i)) {
+            iChanges |= PresentSimsChange;
             Q_EMIT iParent->presentSimChanged(i, iPresentSims.at(i));
         }
     }
     if (aOldList != iPresentSims) {
+        iChanges |= PresentSimsChange;
         Q_EMIT iParent->presentSimsChanged(iPresentSims);
     }
 }
@@ -500,9 +704,11 @@ void QOfonoExtModemManager::Private::updateSimCounts()
         }
     }
     if (oldPresentSimCount != iPresentSimCount) {
+        iChanges |= PresentSimCountChange;
         Q_EMIT iParent->presentSimCountChanged(iPresentSimCount);
     }
     if (oldActiveSimCount != iActiveSimCount) {
+        iChanges |= ActiveSimCountChange;
         Q_EMIT iParent->activeSimCountChanged(iActiveSimCount);
     }
 }
@@ -511,6 +717,7 @@ void QOfonoExtModemManager::Private::updateEnabledModems(QStringList aModems)
 {
     if (iEnabledModems != aModems) {
         iEnabledModems = aModems;
+        iChanges |= EnabledModemsChange;
         Q_EMIT iParent->enabledModemsChanged(aModems);
     }
     updateSimCounts();
@@ -520,6 +727,7 @@ void QOfonoExtModemManager::Private::updateDefaultDataModem(QString aPath)
 {
     if (iDefaultDataModem != aPath) {
         iDefaultDataModem = aPath;
+        iChanges |= DefaultDataModemChange;
         Q_EMIT iParent->defaultDataModemChanged(aPath);
     }
 }
@@ -528,6 +736,7 @@ void QOfonoExtModemManager::Private::updateDefaultVoiceModem(QString aPath)
 {
     if (iDefaultVoiceModem != aPath) {
         iDefaultVoiceModem = aPath;
+        iChanges |= DefaultVoiceModemChange;
         Q_EMIT iParent->defaultVoiceModemChanged(aPath);
     }
 }
@@ -536,6 +745,7 @@ void QOfonoExtModemManager::Private::updateDefaultDataSim(QString aImsi)
 {
     if (iDefaultDataSim != aImsi) {
         iDefaultDataSim = aImsi;
+        iChanges |= DefaultDataSimChange;
         Q_EMIT iParent->defaultDataSimChanged(aImsi);
     }
 }
@@ -544,6 +754,7 @@ void QOfonoExtModemManager::Private::updateDefaultVoiceSim(QString aImsi)
 {
     if (iDefaultVoiceSim != aImsi) {
         iDefaultVoiceSim = aImsi;
+        iChanges |= DefaultVoiceSimChange;
         Q_EMIT iParent->defaultVoiceSimChanged(aImsi);
     }
 }
@@ -552,6 +763,7 @@ void QOfonoExtModemManager::Private::updateMmsSim(QString aImsi)
 {
     if (iMmsSim != aImsi) {
         iMmsSim = aImsi;
+        iChanges |= MmsSimChange;
         Q_EMIT iParent->mmsSimChanged(aImsi);
     }
 }
@@ -560,6 +772,7 @@ void QOfonoExtModemManager::Private::updateMmsModem(QString aPath)
 {
     if (iMmsModem != aPath) {
         iMmsModem = aPath;
+        iChanges |= MmsModemChange;
         Q_EMIT iParent->mmsModemChanged(aPath);
     }
 }
@@ -568,15 +781,82 @@ void QOfonoExtModemManager::Private::updateReady(bool aReady)
 {
     if (iReady != aReady) {
         iReady = aReady;
+        iChanges |= ReadyChange;
         Q_EMIT iParent->readyChanged(aReady);
     }
 }
 
+void QOfonoExtModemManager::Private::updateStale(bool aStale)
+{
+    if (iStale != aStale) {
+        iStale = aStale;
+        iChanges |= StaleChange;
+        Q_EMIT iParent->staleChanged(aStale);
+    }
+}
+
+QOfonoExtModemState QOfonoExtModemManager::Private::currentState() const
+{
+    QOfonoExtModemState state;
+    state.valid = iValid;
+    state.interfaceVersion = iInterfaceVersion;
+    state.availableModems = iAvailableModems;
+    state.enabledModems = iEnabledModems;
+    state.defaultDataModem = iDefaultDataModem;
+    state.defaultVoiceModem = iDefaultVoiceModem;
+    state.defaultDataSim = iDefaultDataSim;
+    state.defaultVoiceSim = iDefaultVoiceSim;
+    state.presentSims = iPresentSims;
+    state.imeiCodes = iIMEIs;
+    state.imeisvCodes = iIMEISVs;
+    state.mmsSim = iMmsSim;
+    state.mmsModem = iMmsModem;
+    state.ready = iReady;
+    state.stale = iStale;
+    state.presentSimCount = iPresentSimCount;
+    state.activeSimCount = iActiveSimCount;
+    state.errorCount = iErrorCount;
+    return state;
+}
+
+void QOfonoExtModemManager::Private::publishState()
+{
+    // Implicitly shared containers are fine to share with the snapshot,
+    // the reference counting is atomic and we never modify them in place.
+    SharedState* state = new SharedState(new QOfonoExtModemState(currentState()));
+    SharedState* old = iSharedState.fetchAndStoreOrdered(state);
+
+    // A reader may still be copying the QSharedPointer out of the old
+    // holder (the snapshot itself lives on in the copies). Holders
+    // replaced earlier are retired too, and all of them get deleted
+    // once there are no readers. A reader which shows up after that
+    // is guaranteed to see the new holder. The counter is read with
+    // a read-modify-write, to be ordered against the readers' ref().
+    if (old) {
+        iRetiredStates.append(old);
+    }
+    if (!iSharedStateReaders.fetchAndAddOrdered(0)) {
+        qDeleteAll(iRetiredStates);
+        iRetiredStates.clear();
+    }
+}
+
+void QOfonoExtModemManager::Private::emitStateChanged()
+{
+    if (iChanges) {
+        const ChangeFlags changes(iChanges);
+        iChanges = NoChange;
+        publishState();
+        Q_EMIT iParent->stateChanged(changes);
+    }
+}
+
 void QOfonoExtModemManager::Private::onEnabledModemsChanged(QList<QDBusObjectPath> aModems)
 {
     if (!iInitCall) {
         updateEnabledModems(toStringList(aModems));
     }
+    emitStateChanged();
 }
 
 void QOfonoExtModemManager::Private::onDefaultDataModemChanged(QString aPath)
@@ -584,6 +864,7 @@ void QOfonoExtModemManager::Private::onDefaultDataModemChanged(QString aPath)
     if (!iInitCall) {
         updateDefaultDataModem(aPath);
     }
+    emitStateChanged();
 }
 
 void QOfonoExtModemManager::Private::onDefaultVoiceModemChanged(QString aPath)
@@ -591,6 +872,7 @@ void QOfonoExtModemManager::Private::onDefaultVoiceModemChanged(QString aPath)
     if (!iInitCall) {
         updateDefaultVoiceModem(aPath);
     }
+    emitStateChanged();
 }
 
 void QOfonoExtModemManager::Private::onDefaultDataSimChanged(QString aImsi)
@@ -598,6 +880,7 @@ void QOfonoExtModemManager::Private::onDefaultDataSimChanged(QString aImsi)
     if (!iInitCall) {
         updateDefaultDataSim(aImsi);
     }
+    emitStateChanged();
 }
 
 void QOfonoExtModemManager::Private::onDefaultVoiceSimChanged(QString aImsi)
@@ -605,6 +888,7 @@ void QOfonoExtModemManager::Private::onDefaultVoiceSimChanged(QString aImsi)
     if (!iInitCall) {
         updateDefaultVoiceSim(aImsi);
     }
+    emitStateChanged();
 }
 
 void QOfonoExtModemManager::Private::onPresentSimsChanged(int aIndex, bool aPresent)
@@ -614,6 +898,7 @@ void QOfonoExtModemManager::Private::onPresentSimsChanged(int aIndex, bool aPres
         iPresentSims[aIndex] = aPresent;
         presentSimsChanged(oldList);
     }
+    emitStateChanged();
 }
 
 void QOfonoExtModemManager::Private::onMmsSimChanged(QString aImsi)
@@ -621,6 +906,7 @@ void QOfonoExtModemManager::Private::onMmsSimChanged(QString aImsi)
     if (!iInitCall) {
         updateMmsSim(aImsi);
     }
+    emitStateChanged();
 }
 
 void QOfonoExtModemManager::Private::onMmsModemChanged(QString aPath)
@@ -628,6 +914,7 @@ void QOfonoExtModemManager::Private::onMmsModemChanged(QString aPath)
     if (!iInitCall) {
         updateMmsModem(aPath);
     }
+    emitStateChanged();
 }
 
 void QOfonoExtModemManager::Private::onReadyChanged(bool aReady)
@@ -635,15 +922,18 @@ void QOfonoExtModemManager::Private::onReadyChanged(bool aReady)
     if (!iInitCall) {
         updateReady(aReady);
     }
+    emitStateChanged();
 }
 
 void QOfonoExtModemManager::Private::onModemError(QDBusObjectPath aPath, QString aName, QString aMessage)
 {
     if (!iInitCall) {
         iErrorCount++;
+        iChanges |= ErrorCountChange;
         Q_EMIT iParent->errorCountChanged(iErrorCount);
         Q_EMIT iParent->modemError(aPath.path(), aName, aMessage);
     }
+    emitStateChanged();
 }
 
 // ==========================================================================
@@ -665,6 +955,11 @@ bool QOfonoExtModemManager::valid() const
     return iPrivate->iValid;
 }
 
+void QOfonoExtModemManager::whenValid(QObject* aContext, std::function<void()> aCallback) // Since 1.0.33
+{
+    QOfonoExt::whenValid(this, &QOfonoExtModemManager::validChanged, aContext, aCallback);
+}
+
 int QOfonoExtModemManager::interfaceVersion() const
 {
     return iPrivate->iInterfaceVersion;
@@ -745,6 +1040,27 @@ int QOfonoExtModemManager::errorCount() const
     return iPrivate->iErrorCount;
 }
 
+bool QOfonoExtModemManager::stale() const // Since 1.0.33
+{
+    return iPrivate->iStale;
+}
+
+QOfonoExtModemState QOfonoExtModemManager::state() const // Since 1.0.33
+{
+    return iPrivate->currentState();
+}
+
+QSharedPointer<const QOfonoExtModemState> QOfonoExtModemManager::sharedState() const // Since 1.0.33
+{
+    // Lock-free, see Private::publishState()
+    Private* priv = iPrivate;
+    priv->iSharedStateReaders.ref();
+    const QSharedPointer<const QOfonoExtModemState> state
+        (*priv->iSharedState.loadAcquire());
+    priv->iSharedStateReaders.deref();
+    return state;
+}
+
 QString QOfonoExtModemManager::imeiAt(int aIndex) const
 {
     if (aIndex >= 0 && aIndex < iPrivate->iIMEIs.count()) {
@@ -780,8 +1096,10 @@ void QOfonoExtModemManager::setEnabledModems(QStringList aModems)
     // Optimistically cache the changes
     if (iPrivate->iEnabledModems != aModems) {
         iPrivate->iEnabledModems = aModems;
+        iPrivate->iChanges |= EnabledModemsChange;
         Q_EMIT enabledModemsChanged(aModems);
     }
+    iPrivate->emitStateChanged();
 }
 
 void QOfonoExtModemManager::setDefaultDataSim(QString aImsi)
@@ -792,8 +1110,10 @@ void QOfonoExtModemManager::setDefaultDataSim(QString aImsi)
     // Optimistically cache the changes
     if (iPrivate->iDefaultDataSim != aImsi) {
         iPrivate->iDefaultDataSim = aImsi;
+        iPrivate->iChanges |= DefaultDataSimChange;
         Q_EMIT defaultDataSimChanged(aImsi);
     }
+    iPrivate->emitStateChanged();
 }
 
 void QOfonoExtModemManager::setDefaultVoiceSim(QString aImsi)
@@ -804,8 +1124,10 @@ void QOfonoExtModemManager::setDefaultVoiceSim(QString aImsi)
     // Optimistically cache the changes
     if (iPrivate->iDefaultVoiceSim != aImsi) {
         iPrivate->iDefaultVoiceSim = aImsi;
+        iPrivate->iChanges |= DefaultVoiceSimChange;
         Q_EMIT defaultVoiceSimChanged(aImsi);
     }
+    iPrivate->emitStateChanged();
 }
 
 QSharedPointer<QOfonoExtModemManager> QOfonoExtModemManager::instance()
@@ -818,4 +1140,9 @@ QSharedPointer<QOfonoExtModemManager> QOfonoExtModemManager::instance()
     return instance;
 }
 
+void QOfonoExtModemManager::setCacheFile(QString aPath) // Since 1.0.33
+{
+    Private::sCacheFile = aPath;
+}
+
 #include "qofonoextmodemmanager.moc"
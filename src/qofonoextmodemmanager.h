@@ -16,7 +16,7 @@
 #ifndef QOFONOEXTMODEMMANAGER_H
 #define QOFONOEXTMODEMMANAGER_H
 
-#include "qofonoext_types.h"
+#include "qofonoextmodemstate.h"
 
 class QOFONOEXT_EXPORT QOfonoExtModemManager : public QObject
 {
@@ -38,8 +38,34 @@ class QOFONOEXT_EXPORT QOfonoExtModemManager : public QObject
     Q_PROPERTY(int presentSimCount READ presentSimCount NOTIFY presentSimCountChanged)
     Q_PROPERTY(int activeSimCount READ activeSimCount NOTIFY activeSimCountChanged)
     Q_PROPERTY(int errorCount READ errorCount NOTIFY errorCountChanged)
+    Q_PROPERTY(bool stale READ stale NOTIFY staleChanged)
+    Q_FLAGS(ChangeFlags)
 
 public:
+    // Since 1.0.33
+    enum Change {
+        NoChange                = 0x00000,
+        ValidChange             = 0x00001,
+        InterfaceVersionChange  = 0x00002,
+        AvailableModemsChange   = 0x00004,
+        EnabledModemsChange     = 0x00008,
+        DefaultDataModemChange  = 0x00010,
+        DefaultVoiceModemChange = 0x00020,
+        DefaultDataSimChange    = 0x00040,
+        DefaultVoiceSimChange   = 0x00080,
+        PresentSimsChange       = 0x00100,
+        PresentSimCountChange   = 0x00200,
+        ActiveSimCountChange    = 0x00400,
+        ImeiCodesChange         = 0x00800,
+        ImeisvCodesChange       = 0x01000,
+        MmsSimChange            = 0x02000,
+        MmsModemChange          = 0x04000,
+        ReadyChange             = 0x08000,
+        ErrorCountChange        = 0x10000,
+        StaleChange             = 0x20000
+    };
+    Q_DECLARE_FLAGS(ChangeFlags, Change)
+
     explicit QOfonoExtModemManager(QObject *parent = nullptr);
     ~QOfonoExtModemManager();
 
@@ -60,6 +86,20 @@ public:
     int presentSimCount() const;
     int activeSimCount() const;
     int errorCount() const;
+    bool stale() const; // Since 1.0.33
+
+    // Consistent copy of all of the above. Since 1.0.33
+    QOfonoExtModemState state() const;
+
+    // Immutable snapshot published after each update. Unlike all other
+    // getters, it may be called from any thread (as long as the object
+    // itself is alive). It takes no locks, the reader and the owning
+    // thread never wait for each other. Since 1.0.33
+    QSharedPointer<const QOfonoExtModemState> sharedState() const;
+
+    // Invokes the callback when the object becomes valid (or right away
+    // if it already is), unless aContext gets destroyed first. Since 1.0.33
+    void whenValid(QObject* aContext, std::function<void()> aCallback);
 
     Q_INVOKABLE QString imeiAt(int aIndex) const;
     Q_INVOKABLE QString imeisvAt(int aIndex) const;
@@ -71,6 +111,15 @@ public:
 
     static QSharedPointer<QOfonoExtModemManager> instance();
 
+    // Enables the on-disk cache of the last known state. If the file
+    // exists, the values are loaded from it at construction time and
+    // marked stale until the live state is received from ofono. Must
+    // be called before the first QOfonoExtModemManager is created.
+    // The file holds device and subscriber identifiers (IMEI, IMEISV
+    // and IMSI) and is written readable by the owner only, so it
+    // should be placed in a private directory too. Since 1.0.33
+    static void setCacheFile(QString aPath);
+
 Q_SIGNALS:
     void validChanged(bool value);
     void interfaceVersionChanged(int value);
@@ -90,6 +139,10 @@ Q_SIGNALS:
     void mmsModemChanged(QString value);
     void readyChanged(bool value);
     void errorCountChanged(int value);
+    void staleChanged(bool value); // Since 1.0.33
+
+    // Emitted once per update, after the individual signals. Since 1.0.33
+    void stateChanged(QOfonoExtModemManager::ChangeFlags changes);
     void modemError(QString modemPath, QString errorId, QString errorMessage);
 
 private:
@@ -97,4 +150,6 @@ private:
     Private* iPrivate;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(QOfonoExtModemManager::ChangeFlags)
+
 #endif // QOFONOEXTMODEMMANAGER_H
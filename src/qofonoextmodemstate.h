@@ -0,0 +1,49 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef QOFONOEXTMODEMSTATE_H
+#define QOFONOEXTMODEMSTATE_H
+
+#include "qofonoext_types.h"
+
+// Snapshot of QOfonoExtModemManager state (since 1.0.33)
+struct QOfonoExtModemState
+{
+    QOfonoExtModemState() :
+        valid(false), interfaceVersion(0), ready(false), stale(false),
+        presentSimCount(0), activeSimCount(0), errorCount(0) {}
+
+    bool valid;
+    int interfaceVersion;
+    QStringList availableModems;
+    QStringList enabledModems;
+    QString defaultDataModem;
+    QString defaultVoiceModem;
+    QString defaultDataSim;
+    QString defaultVoiceSim;
+    QList<bool> presentSims;
+    QStringList imeiCodes;
+    QStringList imeisvCodes;
+    QString mmsSim;
+    QString mmsModem;
+    bool ready;
+    bool stale;
+    int presentSimCount;
+    int activeSimCount;
+    int errorCount;
+};
+
+Q_DECLARE_METATYPE(QOfonoExtModemState)
+
+#endif // QOFONOEXTMODEMSTATE_H
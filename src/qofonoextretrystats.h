@@ -0,0 +1,38 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef QOFONOEXTRETRYSTATS_H
+#define QOFONOEXTRETRYSTATS_H
+
+#include "qofonoext_types.h"
+
+// Counters of D-Bus calls re-issued after a timeout (since 1.0.33)
+//
+// Retries are delayed by a jittered exponential backoff, and no more
+// than maxActive() retried calls are in flight at any time.
+struct QOFONOEXT_EXPORT QOfonoExtRetryStats
+{
+    quint64 scheduled;  // Retries scheduled after a timeout
+    quint64 started;    // Retried calls actually issued
+    quint64 succeeded;  // Retried calls which have succeeded
+    quint64 cancelled;  // Retries dropped before completion
+    int waiting;        // Backoff has expired, waiting for a free slot
+    int active;         // Retried calls in flight
+
+    static QOfonoExtRetryStats current();
+    static int maxActive();
+    static void setMaxActive(int aMaxActive);
+};
+
+#endif // QOFONOEXTRETRYSTATS_H
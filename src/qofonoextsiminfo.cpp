@@ -18,63 +18,46 @@
 
 #include <qofonomodem.h>
 
-// ==========================================================================
-// QOfonoExtSimInfoProxy
-//
-// qdbusxml2cpp doesn't really do much, and has a number of limitations,
-// such as the limits on number of arguments for QDBusPendingReply template.
-// It's easier to write these proxies by hand.
-// ==========================================================================
-
-class QOfonoExtSimInfoProxy: public QDBusAbstractInterface
-{
-    Q_OBJECT
-
-public:
-    static const QString INTERFACE;
-    QOfonoExtSimInfoProxy(QString aPath, QObject* aParent) :
-        QDBusAbstractInterface(OFONO_SERVICE, aPath, qPrintable(INTERFACE),
-            OFONO_BUS, aParent) {}
-
-public Q_SLOTS: // METHODS
-    QDBusPendingCall GetInterfaceVersion()
-        { return asyncCall("GetInterfaceVersion"); }
-    QDBusPendingCall GetAll()
-        { return asyncCall("GetAll"); }
-
-Q_SIGNALS: // SIGNALS
-    void CardIdentifierChanged(QString aIccid);
-    void ServiceProviderNameChanged(QString aSpn);
-    void SubscriberIdentityChanged(QString aImsi);
-};
-
-const QString QOfonoExtSimInfoProxy::INTERFACE("org.nemomobile.ofono.SimInfo");
+static const QString kInterface("org.nemomobile.ofono.SimInfo");
+static const QString kMethodGetAll("GetAll");
+static const QString kSignalCardIdentifierChanged("CardIdentifierChanged");
+static const QString kSignalServiceProviderNameChanged("ServiceProviderNameChanged");
+static const QString kSignalSubscriberIdentityChanged("SubscriberIdentityChanged");
 
 // ==========================================================================
-// QOfonoExtSimInfo::Private
+// QOfonoExtSimInfoBackend
+//
+// One per modem, shared by all QOfonoExtSimInfo objects watching the same
+// modem, so that there's only one proxy and one GetAll call per modem.
 // ==========================================================================
 
-class QOfonoExtSimInfo::Private : public QObject
+class QOfonoExtSimInfoBackend : public QObject
 {
     Q_OBJECT
 
 public:
-    QOfonoExtSimInfo* iParent;
-    QOfonoExtSimInfoProxy* iProxy;
+    QOfonoExtProxy* iProxy;
     QSharedPointer<QOfonoModem> iModem;
     bool iValid;
     QString iModemPath;
     QString iCardIdentifier;
     QString iSubscriberIdentity;
     QString iServiceProviderName;
+    QOfonoExtRetry iRetry;
 
-    Private(QOfonoExtSimInfo* aParent);
+    QOfonoExtSimInfoBackend(QString aPath);
+
+    static QSharedPointer<QOfonoExtSimInfoBackend> instance(QString aPath);
 
-    QString modemPath() const;
-    void setModemPath(QString aPath);
     void invalidate();
     void getAll();
 
+Q_SIGNALS:
+    void validChanged(bool value);
+    void cardIdentifierChanged(QString value);
+    void subscriberIdentityChanged(QString value);
+    void serviceProviderNameChanged(QString value);
+
 private Q_SLOTS:
     void checkInterfacePresence();
     void onGetAllFinished(QDBusPendingCallWatcher* aWatcher);
@@ -83,56 +66,50 @@ private Q_SLOTS:
     void onServiceProviderNameChanged(QString aServiceProviderName);
 };
 
-QOfonoExtSimInfo::Private::Private(QOfonoExtSimInfo* aParent) :
-    QObject(aParent),
-    iParent(aParent),
-    iProxy(NULL),
-    iValid(false)
-{
-}
+typedef QMap<QString,QWeakPointer<QOfonoExtSimInfoBackend> > QOfonoExtSimInfoBackendMap;
+Q_GLOBAL_STATIC(QOfonoExtSimInfoBackendMap, sharedBackends)
 
-QString QOfonoExtSimInfo::Private::modemPath() const
+typedef QMap<QString,QWeakPointer<QOfonoExtSimInfo> > QOfonoExtSimInfoMap;
+Q_GLOBAL_STATIC(QOfonoExtSimInfoMap, sharedInstances)
+
+QOfonoExtSimInfoBackend::QOfonoExtSimInfoBackend(QString aPath) :
+    iProxy(NULL),
+    iModem(QOfonoModem::instance(aPath)),
+    iValid(false),
+    iModemPath(aPath)
 {
-    return iModem.isNull() ? QString() : iModem->objectPath();
+    connect(iModem.data(),
+        SIGNAL(validChanged(bool)),
+        SLOT(checkInterfacePresence()));
+    connect(iModem.data(),
+        SIGNAL(interfacesChanged(QStringList)),
+        SLOT(checkInterfacePresence()));
+    checkInterfacePresence();
 }
 
-void QOfonoExtSimInfo::Private::setModemPath(QString aPath)
+QSharedPointer<QOfonoExtSimInfoBackend> QOfonoExtSimInfoBackend::instance(QString aPath)
 {
-    if (aPath != modemPath()) {
-        invalidate();
-        if (aPath.isEmpty()) {
-            iModem.clear();
-        } else {
-            if (iModem) iModem->disconnect(this);
-            iModem = QOfonoModem::instance(aPath);
-            connect(iModem.data(),
-                SIGNAL(validChanged(bool)),
-                SLOT(checkInterfacePresence()));
-            connect(iModem.data(),
-                SIGNAL(interfacesChanged(QStringList)),
-                SLOT(checkInterfacePresence()));
-            checkInterfacePresence();
-        }
-        iParent->modemPathChanged(modemPath());
+    QSharedPointer<QOfonoExtSimInfoBackend> ptr = sharedBackends()->value(aPath);
+    if (ptr.isNull()) {
+        ptr = QSharedPointer<QOfonoExtSimInfoBackend>(new
+            QOfonoExtSimInfoBackend(aPath), &QObject::deleteLater);
+        sharedBackends()->insert(aPath, QWeakPointer<QOfonoExtSimInfoBackend>(ptr));
     }
+    return ptr;
 }
 
-void QOfonoExtSimInfo::Private::checkInterfacePresence()
+void QOfonoExtSimInfoBackend::checkInterfacePresence()
 {
-    if (iModem && iModem->isValid() &&
-        iModem->interfaces().contains(QOfonoExtSimInfoProxy::INTERFACE)) {
+    if (iModem->isValid() &&
+        iModem->interfaces().contains(kInterface)) {
         if (!iProxy) {
-            iProxy = new QOfonoExtSimInfoProxy(iModem->objectPath(), this);
-            if (iProxy->isValid()) {
-                connect(iProxy,
-                    SIGNAL(CardIdentifierChanged(QString)),
-                    SLOT(onCardIdentifierChanged(QString)));
-                connect(iProxy,
-                    SIGNAL(SubscriberIdentityChanged(QString)),
-                    SLOT(onSubscriberIdentityChanged(QString)));
-                connect(iProxy,
-                    SIGNAL(ServiceProviderNameChanged(QString)),
-                    SLOT(onServiceProviderNameChanged(QString)));
+            iProxy = new QOfonoExtProxy(iModemPath, kInterface, this);
+            if (iProxy->connectSignal(kSignalCardIdentifierChanged, this,
+                    SLOT(onCardIdentifierChanged(QString))) &&
+                iProxy->connectSignal(kSignalSubscriberIdentityChanged, this,
+                    SLOT(onSubscriberIdentityChanged(QString))) &&
+                iProxy->connectSignal(kSignalServiceProviderNameChanged, this,
+                    SLOT(onServiceProviderNameChanged(QString)))) {
                 getAll();
             } else {
                 invalidate();
@@ -143,26 +120,27 @@ void QOfonoExtSimInfo::Private::checkInterfacePresence()
     }
 }
 
-void QOfonoExtSimInfo::Private::invalidate()
+void QOfonoExtSimInfoBackend::invalidate()
 {
+    iRetry.cancel();
     if (iProxy) {
         delete iProxy;
         iProxy = NULL;
     }
     if (iValid) {
         iValid = false;
-        Q_EMIT iParent->validChanged(false);
+        Q_EMIT validChanged(false);
     }
 }
 
-void QOfonoExtSimInfo::Private::getAll()
+void QOfonoExtSimInfoBackend::getAll()
 {
-    connect(new QDBusPendingCallWatcher(iProxy->GetAll(), iProxy),
+    connect(new QDBusPendingCallWatcher(iProxy->asyncCall(kMethodGetAll), iProxy),
         SIGNAL(finished(QDBusPendingCallWatcher*)),
         SLOT(onGetAllFinished(QDBusPendingCallWatcher*)));
 }
 
-void QOfonoExtSimInfo::Private::onGetAllFinished(QDBusPendingCallWatcher* aWatcher)
+void QOfonoExtSimInfoBackend::onGetAllFinished(QDBusPendingCallWatcher* aWatcher)
 {
     QDBusPendingReply<int,      // InterfaceVersion
         QString,                // CardIdentifier
@@ -173,53 +151,130 @@ void QOfonoExtSimInfo::Private::onGetAllFinished(QDBusPendingCallWatcher* aWatch
         // Repeat the call on timeout
         qWarning() << reply.error();
         if (QOfonoExt::isTimeout(reply.error())) {
-            getAll();
+            iRetry.schedule([this]() { getAll(); });
+        } else {
+            iRetry.finished(false);
         }
     } else {
+        iRetry.finished(true);
         QString iccid = reply.argumentAt<1>();
         if (iCardIdentifier != iccid) {
             iCardIdentifier = iccid;
-            Q_EMIT iParent->cardIdentifierChanged(iccid);
+            Q_EMIT cardIdentifierChanged(iccid);
         }
         QString imsi = reply.argumentAt<2>();
         if (iSubscriberIdentity != imsi) {
             iSubscriberIdentity = imsi;
-            Q_EMIT iParent->subscriberIdentityChanged(imsi);
+            Q_EMIT subscriberIdentityChanged(imsi);
         }
         QString spn = reply.argumentAt<3>();
         if (iServiceProviderName != spn) {
             iServiceProviderName = spn;
-            Q_EMIT iParent->serviceProviderNameChanged(spn);
+            Q_EMIT serviceProviderNameChanged(spn);
         }
         if (!iValid) {
             iValid = true;
-            Q_EMIT iParent->validChanged(iValid);
+            Q_EMIT validChanged(iValid);
         }
     }
     aWatcher->deleteLater();
 }
 
-void QOfonoExtSimInfo::Private::onCardIdentifierChanged(QString aValue)
+void QOfonoExtSimInfoBackend::onCardIdentifierChanged(QString aValue)
 {
     if (iCardIdentifier != aValue) {
         iCardIdentifier = aValue;
-        Q_EMIT iParent->cardIdentifierChanged(aValue);
+        Q_EMIT cardIdentifierChanged(aValue);
     }
 }
 
-void QOfonoExtSimInfo::Private::onSubscriberIdentityChanged(QString aValue)
+void QOfonoExtSimInfoBackend::onSubscriberIdentityChanged(QString aValue)
 {
     if (iSubscriberIdentity != aValue) {
         iSubscriberIdentity = aValue;
-        Q_EMIT iParent->subscriberIdentityChanged(aValue);
+        Q_EMIT subscriberIdentityChanged(aValue);
     }
 }
 
-void QOfonoExtSimInfo::Private::onServiceProviderNameChanged(QString aValue)
+void QOfonoExtSimInfoBackend::onServiceProviderNameChanged(QString aValue)
 {
     if (iServiceProviderName != aValue) {
         iServiceProviderName = aValue;
-        Q_EMIT iParent->serviceProviderNameChanged(aValue);
+        Q_EMIT serviceProviderNameChanged(aValue);
+    }
+}
+
+// ==========================================================================
+// QOfonoExtSimInfo::Private
+// ==========================================================================
+
+class QOfonoExtSimInfo::Private
+{
+public:
+    QOfonoExtSimInfo* iParent;
+    QSharedPointer<QOfonoExtSimInfoBackend> iBackend;
+    bool iFixedPath;
+
+    Private(QOfonoExtSimInfo* aParent);
+
+    QString modemPath() const;
+    void setModemPath(QString aPath);
+};
+
+QOfonoExtSimInfo::Private::Private(QOfonoExtSimInfo* aParent) :
+    iParent(aParent),
+    iFixedPath(false)
+{
+}
+
+QString QOfonoExtSimInfo::Private::modemPath() const
+{
+    return iBackend.isNull() ? QString() : iBackend->iModemPath;
+}
+
+void QOfonoExtSimInfo::Private::setModemPath(QString aPath)
+{
+    if (aPath != modemPath()) {
+        const bool wasValid = iParent->valid();
+        const QString iccid(iParent->cardIdentifier());
+        const QString imsi(iParent->subscriberIdentity());
+        const QString spn(iParent->serviceProviderName());
+
+        if (iBackend) {
+            iBackend->disconnect(iParent);
+        }
+        if (aPath.isEmpty()) {
+            iBackend.clear();
+        } else {
+            // The backend may be already up and running
+            iBackend = QOfonoExtSimInfoBackend::instance(aPath);
+            iParent->connect(iBackend.data(),
+                SIGNAL(validChanged(bool)),
+                SIGNAL(validChanged(bool)));
+            iParent->connect(iBackend.data(),
+                SIGNAL(cardIdentifierChanged(QString)),
+                SIGNAL(cardIdentifierChanged(QString)));
+            iParent->connect(iBackend.data(),
+                SIGNAL(subscriberIdentityChanged(QString)),
+                SIGNAL(subscriberIdentityChanged(QString)));
+            iParent->connect(iBackend.data(),
+                SIGNAL(serviceProviderNameChanged(QString)),
+                SIGNAL(serviceProviderNameChanged(QString)));
+        }
+
+        if (iParent->cardIdentifier() != iccid) {
+            Q_EMIT iParent->cardIdentifierChanged(iParent->cardIdentifier());
+        }
+        if (iParent->subscriberIdentity() != imsi) {
+            Q_EMIT iParent->subscriberIdentityChanged(iParent->subscriberIdentity());
+        }
+        if (iParent->serviceProviderName() != spn) {
+            Q_EMIT iParent->serviceProviderNameChanged(iParent->serviceProviderName());
+        }
+        if (iParent->valid() != wasValid) {
+            Q_EMIT iParent->validChanged(iParent->valid());
+        }
+        Q_EMIT iParent->modemPathChanged(modemPath());
     }
 }
 
@@ -235,11 +290,25 @@ QOfonoExtSimInfo::QOfonoExtSimInfo(QObject* aParent) :
 
 QOfonoExtSimInfo::~QOfonoExtSimInfo()
 {
+    delete iPrivate;
+}
+
+QSharedPointer<QOfonoExtSimInfo> QOfonoExtSimInfo::instance(QString aPath) // Since 1.0.33
+{
+    QSharedPointer<QOfonoExtSimInfo> ptr = sharedInstances()->value(aPath);
+    if (ptr.isNull()) {
+        QOfonoExtSimInfo* simInfo = new QOfonoExtSimInfo();
+        simInfo->setModemPath(aPath);
+        simInfo->iPrivate->iFixedPath = true;
+        ptr = QSharedPointer<QOfonoExtSimInfo>(simInfo, &QObject::deleteLater);
+        sharedInstances()->insert(aPath, QWeakPointer<QOfonoExtSimInfo>(ptr));
+    }
+    return ptr;
 }
 
 bool QOfonoExtSimInfo::valid() const
 {
-    return iPrivate->iValid;
+    return iPrivate->iBackend && iPrivate->iBackend->iValid;
 }
 
 QString QOfonoExtSimInfo::modemPath() const
@@ -249,22 +318,28 @@ QString QOfonoExtSimInfo::modemPath() const
 
 QString QOfonoExtSimInfo::cardIdentifier() const
 {
-    return iPrivate->iCardIdentifier;
+    return iPrivate->iBackend ? iPrivate->iBackend->iCardIdentifier : QString();
 }
 
 QString QOfonoExtSimInfo::subscriberIdentity() const
 {
-    return iPrivate->iSubscriberIdentity;
+    return iPrivate->iBackend ? iPrivate->iBackend->iSubscriberIdentity : QString();
 }
 
 QString QOfonoExtSimInfo::serviceProviderName() const
 {
-    return iPrivate->iServiceProviderName;
+    return iPrivate->iBackend ? iPrivate->iBackend->iServiceProviderName : QString();
 }
 
 void QOfonoExtSimInfo::setModemPath(QString aPath)
 {
-    iPrivate->setModemPath(aPath);
+    if (iPrivate->modemPath() != aPath) {
+        if (iPrivate->iFixedPath) {
+            qWarning() << "Attempting to change fixed path" << iPrivate->modemPath();
+        } else {
+            iPrivate->setModemPath(aPath);
+        }
+    }
 }
 
 #include "qofonoextsiminfo.moc"
@@ -39,6 +39,10 @@ public:
 
     void setModemPath(QString aPath);
 
+    // Shared instance(s) for C++ use. All QOfonoExtSimInfo objects
+    // watching the same modem share the D-Bus state anyway. Since 1.0.33
+    static QSharedPointer<QOfonoExtSimInfo> instance(QString aModemPath);
+
 Q_SIGNALS:
     void validChanged(bool value);
     void modemPathChanged(QString value);
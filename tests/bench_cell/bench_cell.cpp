@@ -0,0 +1,275 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include <QtTest>
+
+#include "testbus.h"
+#include "testmetrics.h"
+#include "mockofono.h"
+
+#include "qofonoextcell.h"
+
+#define MODEM_PATH "/ril_0"
+#define NEIGHBOUR_COUNT 31
+
+class BenchCell : public QObject
+{
+    Q_OBJECT
+
+public:
+    BenchCell();
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void timeToValid();
+    void updates();
+    void updatesCoalesced();
+    void watchedAmongNeighbours_data();
+    void watchedAmongNeighbours();
+    void workerThread_data();
+    void workerThread();
+    void sharedBackend_data();
+    void sharedBackend();
+
+private:
+    MockOfono* iMock;
+    QString iServingCell;
+    QStringList iNeighbours;
+    int iNextValue;
+};
+
+BenchCell::BenchCell() :
+    iMock(Q_NULLPTR),
+    iNextValue(44)
+{
+}
+
+void BenchCell::initTestCase()
+{
+    iMock = new MockOfono;
+    QVERIFY(iMock->start(TestBus::systemBusAddress()));
+    iMock->addModem(MODEM_PATH, "350000000000001", "244910000000001");
+    iServingCell = iMock->addCell(MODEM_PATH, MockOfono::Cell("lte", true,
+        MockOfono::lteProperties(1000, 90)));
+    for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+        iNeighbours.append(iMock->addCell(MODEM_PATH, MockOfono::Cell("lte",
+            false, MockOfono::lteProperties(1001 + i, 110))));
+    }
+}
+
+void BenchCell::cleanupTestCase()
+{
+    delete iMock;
+    iMock = Q_NULLPTR;
+}
+
+void BenchCell::timeToValid()
+{
+    const int n = 50;
+    TestMetrics metrics;
+
+    for (int i = 0; i < n; i++) {
+        QOfonoExtCell* cell = new QOfonoExtCell(iServingCell);
+        QVERIFY(TestMetrics::waitFor([cell]() { return cell->valid(); }));
+        delete cell;
+        // Let the backend go, so that the next one starts from scratch
+        QCoreApplication::sendPostedEvents(Q_NULLPTR, QEvent::DeferredDelete);
+    }
+
+    metrics.report("QOfonoExtCell time-to-valid", n);
+}
+
+void BenchCell::updates()
+{
+    const int n = 2000;
+    QOfonoExtCell cell(iServingCell);
+    QVERIFY(TestMetrics::waitFor([&cell]() { return cell.valid(); }));
+
+    QSignalSpy spy(&cell, SIGNAL(rsrpChanged()));
+    const int last = iNextValue + n - 1;
+    TestMetrics metrics;
+
+    iMock->storm(QStringList(iServingCell), "rsrp", n, iNextValue);
+    iNextValue += n;
+    QVERIFY(TestMetrics::waitFor([&cell,last]() { return cell.rsrp() == last; }));
+
+    metrics.report("QOfonoExtCell per update", n);
+    qInfo("rsrpChanged emitted %d times for %d updates", spy.count(), n);
+}
+
+void BenchCell::updatesCoalesced()
+{
+    // Same storm spread over time, the way a modem actually reports
+    const int n = 200;
+    QOfonoExtCell cell(iServingCell);
+    QVERIFY(TestMetrics::waitFor([&cell]() { return cell.valid(); }));
+    cell.setCoalesceInterval(100);
+
+    QSignalSpy spy(&cell, SIGNAL(rsrpChanged()));
+    const int last = iNextValue + n - 1;
+    TestMetrics metrics;
+
+    iMock->storm(QStringList(iServingCell), "rsrp", n, iNextValue, 5);
+    iNextValue += n;
+    QVERIFY(TestMetrics::waitFor([&cell,last]() { return cell.rsrp() == last; }));
+
+    metrics.report("QOfonoExtCell per update, 100 ms coalescing", n);
+    qInfo("rsrpChanged emitted %d times for %d updates", spy.count(), n);
+}
+
+void BenchCell::watchedAmongNeighbours_data()
+{
+    QTest::addColumn<int>("watched");
+
+    // Per-path match rules up to 8 cells, one path-less rule above that
+    QTest::newRow("1 of 32") << 1;
+    QTest::newRow("8 of 32") << 8;
+    QTest::newRow("16 of 32") << 16;
+    QTest::newRow("32 of 32") << 32;
+}
+
+void BenchCell::watchedAmongNeighbours()
+{
+    // All cells of the modem keep changing, only some are being watched
+    QFETCH(int, watched);
+    const int rounds = 100;
+    const QStringList all(QStringList(iServingCell) + iNeighbours);
+    QList<QSharedPointer<QOfonoExtCell> > cells;
+
+    for (int i = 0; i < watched; i++) {
+        cells.append(QSharedPointer<QOfonoExtCell>(new QOfonoExtCell(all.at(i))));
+    }
+    QVERIFY(TestMetrics::waitFor([&cells]() {
+        for (int i = 0; i < cells.count(); i++) {
+            if (!cells.at(i)->valid()) return false;
+        }
+        return true; }));
+
+    const int last = iNextValue + rounds - 1;
+    TestMetrics metrics;
+
+    // The watched cells go last in each round, so once they have the
+    // final value the signals for the rest have been handled as well
+    iMock->storm(all.mid(watched) + all.mid(0, watched), "rsrp", rounds,
+        iNextValue);
+    iNextValue += rounds;
+    QVERIFY(TestMetrics::waitFor([&cells,last]() {
+        for (int i = 0; i < cells.count(); i++) {
+            if (cells.at(i)->rsrp() != last) return false;
+        }
+        return true; }, 30000));
+
+    QByteArray label("QOfonoExtCell per watched update, ");
+    label.append(QTest::currentDataTag());
+    metrics.report(label.constData(), rounds * watched);
+}
+
+void BenchCell::workerThread_data()
+{
+    QTest::addColumn<bool>("enabled");
+    QTest::addColumn<int>("batch");
+
+    QTest::newRow("direct") << false << 0;
+    QTest::newRow("worker") << true << 0;
+    QTest::newRow("worker, 20 ms batches") << true << 20;
+}
+
+void BenchCell::workerThread()
+{
+    // What the GUI thread pays for a storm on every cell of the modem.
+    // Only the CPU time of this thread is charged, the worker's isn't.
+    QFETCH(bool, enabled);
+    QFETCH(int, batch);
+    const int rounds = 100;
+    const QStringList all(QStringList(iServingCell) + iNeighbours);
+    QList<QSharedPointer<QOfonoExtCell> > cells;
+
+    // The setting can only be changed when no cells are left, and
+    // the backends of the previous ones go away with deleteLater()
+    QCoreApplication::sendPostedEvents(Q_NULLPTR, QEvent::DeferredDelete);
+    QVERIFY(QOfonoExtCell::setWorkerThreadEnabled(enabled, batch));
+    for (int i = 0; i < all.count(); i++) {
+        cells.append(QSharedPointer<QOfonoExtCell>(new QOfonoExtCell(all.at(i))));
+    }
+    QVERIFY(TestMetrics::waitFor([&cells]() {
+        for (int i = 0; i < cells.count(); i++) {
+            if (!cells.at(i)->valid()) return false;
+        }
+        return true; }));
+
+    const int last = iNextValue + rounds - 1;
+    TestMetrics metrics;
+
+    iMock->storm(all, "rsrp", rounds, iNextValue);
+    iNextValue += rounds;
+    QVERIFY(TestMetrics::waitFor([&cells,last]() {
+        for (int i = 0; i < cells.count(); i++) {
+            if (cells.at(i)->rsrp() != last) return false;
+        }
+        return true; }, 30000));
+
+    QByteArray label("QOfonoExtCell GUI thread per update, ");
+    label.append(QTest::currentDataTag());
+    metrics.report(label.constData(), rounds * all.count());
+
+    cells.clear();
+    QCoreApplication::sendPostedEvents(Q_NULLPTR, QEvent::DeferredDelete);
+    QVERIFY(QOfonoExtCell::setWorkerThreadEnabled(false));
+}
+
+void BenchCell::sharedBackend_data()
+{
+    QTest::addColumn<int>("fronts");
+
+    QTest::newRow("1 front") << 1;
+    QTest::newRow("10 fronts") << 10;
+    QTest::newRow("50 fronts") << 50;
+}
+
+void BenchCell::sharedBackend()
+{
+    // Many QML bindings and watchers showing the same serving cell.
+    // They all should share a single backend and a single GetAll.
+    QFETCH(int, fronts);
+    const int rounds = 10;
+    QCoreApplication::sendPostedEvents(Q_NULLPTR, QEvent::DeferredDelete);
+    iMock->resetCallCounts();
+
+    TestMetrics metrics;
+    for (int r = 0; r < rounds; r++) {
+        QList<QSharedPointer<QOfonoExtCell> > cells;
+        for (int i = 0; i < fronts; i++) {
+            cells.append(QSharedPointer<QOfonoExtCell>
+                (new QOfonoExtCell(iServingCell)));
+        }
+        QVERIFY(TestMetrics::waitFor([&cells]() {
+            for (int i = 0; i < cells.count(); i++) {
+                if (!cells.at(i)->valid()) return false;
+            }
+            return true; }));
+        cells.clear();
+        QCoreApplication::sendPostedEvents(Q_NULLPTR, QEvent::DeferredDelete);
+    }
+
+    QByteArray label("QOfonoExtCell time-to-valid per front, ");
+    label.append(QTest::currentDataTag());
+    metrics.report(label.constData(), rounds * fronts);
+    qInfo("%.1f Cell.GetAll calls per %d fronts", double(iMock->callCount(
+        "org.nemomobile.ofono.Cell", "GetAll")) / rounds, fronts);
+}
+
+TESTBUS_MAIN(BenchCell)
+
+#include "bench_cell.moc"
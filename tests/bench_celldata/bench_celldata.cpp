@@ -0,0 +1,241 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include <QtTest>
+
+#include "testbus.h"
+#include "testmetrics.h"
+#include "mockofono.h"
+
+#include "qofonoextcelldata_p.h"
+
+class BenchCellData : public QObject
+{
+    Q_OBJECT
+
+public:
+    BenchCellData();
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void propertyFromString_data();
+    void propertyFromString();
+    void parseGetAll_data();
+    void parseGetAll();
+
+private:
+    static QOfonoExtCell::Property linearPropertyFromString(const QString& aProperty);
+    static void mapParseProperties(const QVariantMap& aVariants, int* aProperties, qint64* aNci);
+    static QStringList keys(const char* aSet);
+
+private:
+    static QString sNames[QOfonoExtCell::PropertyCount];
+    MockOfono* iMock;
+    QVariant iGetAllProperties;
+};
+
+QString BenchCellData::sNames[QOfonoExtCell::PropertyCount];
+
+BenchCellData::BenchCellData() :
+    iMock(Q_NULLPTR)
+{
+}
+
+// What propertyFromString() used to be: compare against each name in turn
+QOfonoExtCell::Property BenchCellData::linearPropertyFromString(const QString& aProperty)
+{
+    for (int i = 0; i < QOfonoExtCell::PropertyCount; i++) {
+        if (sNames[i] == aProperty) {
+            return (QOfonoExtCell::Property)i;
+        }
+    }
+    return QOfonoExtCell::PropertyUnknown;
+}
+
+// What parseProperties() used to be: QtDBus builds a QVariantMap first
+void BenchCellData::mapParseProperties(const QVariantMap& aVariants,
+    int* aProperties, qint64* aNci)
+{
+    QOfonoExtCellData::Private::invalidateValues(aProperties, aNci);
+    for (QVariantMap::ConstIterator it = aVariants.constBegin();
+         it != aVariants.constEnd(); it++) {
+        const QString key(it.key());
+        const QVariant value(it.value());
+
+        if (key == QLatin1String("nci")) {
+            bool ok = false;
+            qint64 int64Value = value.toLongLong(&ok);
+            if (ok) {
+                *aNci = int64Value;
+            }
+        } else {
+            bool ok = false;
+            int intValue = value.toInt(&ok);
+            if (ok) {
+                QOfonoExtCell::Property p = QOfonoExtCellData::Private::propertyFromString(key);
+                if (p != QOfonoExtCell::PropertyUnknown) {
+                    aProperties[p] = intValue;
+                }
+            }
+        }
+    }
+}
+
+QStringList BenchCellData::keys(const char* aSet)
+{
+    QStringList list;
+    if (!qstrcmp(aSet, "all")) {
+        for (int i = 0; i < QOfonoExtCell::PropertyCount; i++) {
+            list.append(sNames[i]);
+        }
+    } else if (!qstrcmp(aSet, "lte")) {
+        // A typical serving LTE cell update
+        list << "mcc" << "mnc" << "signalStrength" << "ci" << "pci" << "tac" <<
+            "earfcn" << "rsrp" << "rsrq" << "rssnr" << "cqi" << "timingAdvance";
+    } else if (!qstrcmp(aSet, "unknown")) {
+        list << "nci" << "foo" << "rsrpx" << "csiSinR" << "";
+    }
+    return list;
+}
+
+void BenchCellData::initTestCase()
+{
+    for (int i = 0; i < QOfonoExtCell::PropertyCount; i++) {
+        sNames[i] = QString::fromLatin1(QOfonoExtCellData::Private::PropertyNames[i]);
+    }
+
+    // Both must agree on every name before comparing their speed
+    const QStringList all(keys("all") + keys("unknown"));
+    for (int i = 0; i < all.count(); i++) {
+        QCOMPARE(QOfonoExtCellData::Private::propertyFromString(all.at(i)),
+            linearPropertyFromString(all.at(i)));
+    }
+
+    // A real Cell.GetAll reply, as it comes off the bus
+    iMock = new MockOfono;
+    QVERIFY(iMock->start(TestBus::systemBusAddress()));
+    iMock->addModem("/ril_0", "350000000000001", "244910000000001");
+    const QString path(iMock->addCell("/ril_0", MockOfono::Cell("lte", true,
+        MockOfono::lteProperties(1000, 90))));
+    const QDBusMessage reply(QDBusConnection::systemBus().call(
+        QDBusMessage::createMethodCall("org.ofono", path,
+        "org.nemomobile.ofono.Cell", "GetAll")));
+    QCOMPARE(reply.arguments().count(), 4);
+    iGetAllProperties = reply.arguments().at(3);
+
+    // Both parsers must agree before comparing their speed
+    int props[QOfonoExtCell::PropertyCount], mapProps[QOfonoExtCell::PropertyCount];
+    qint64 nci, mapNci;
+    QOfonoExtCellData::Private::parseProperties(
+        qvariant_cast<QDBusArgument>(iGetAllProperties), props, &nci);
+    mapParseProperties(qdbus_cast<QVariantMap>(iGetAllProperties), mapProps, &mapNci);
+    QCOMPARE(nci, mapNci);
+    for (int i = 0; i < QOfonoExtCell::PropertyCount; i++) {
+        QCOMPARE(props[i], mapProps[i]);
+    }
+    QCOMPARE(props[QOfonoExtCell::PropertyRsrp], 90);
+}
+
+void BenchCellData::cleanupTestCase()
+{
+    delete iMock;
+    iMock = Q_NULLPTR;
+}
+
+void BenchCellData::propertyFromString_data()
+{
+    QTest::addColumn<QString>("set");
+    QTest::addColumn<bool>("linear");
+
+    static const char* sets[] = { "all", "lte", "unknown" };
+    for (uint i = 0; i < sizeof(sets)/sizeof(sets[0]); i++) {
+        QTest::newRow(QByteArray(sets[i]).append(" hash").constData()) <<
+            QString(sets[i]) << false;
+        QTest::newRow(QByteArray(sets[i]).append(" linear").constData()) <<
+            QString(sets[i]) << true;
+    }
+}
+
+void BenchCellData::propertyFromString()
+{
+    QFETCH(QString, set);
+    QFETCH(bool, linear);
+
+    const QStringList list(keys(set.toLatin1().constData()));
+    const int n = list.count();
+    int found = 0;
+
+    // Keys in a message are separate strings, not shared with the table
+    QVector<QString> input;
+    for (int i = 0; i < n; i++) {
+        input.append(QString(list.at(i).constData(), list.at(i).length()));
+    }
+
+    if (linear) {
+        QBENCHMARK {
+            for (int i = 0; i < n; i++) {
+                found += (linearPropertyFromString(input.at(i)) !=
+                    QOfonoExtCell::PropertyUnknown);
+            }
+        }
+    } else {
+        QBENCHMARK {
+            for (int i = 0; i < n; i++) {
+                found += (QOfonoExtCellData::Private::propertyFromString(input.at(i)) !=
+                    QOfonoExtCell::PropertyUnknown);
+            }
+        }
+    }
+
+    // Keep the loop from being optimized away
+    QVERIFY(found >= 0);
+}
+
+void BenchCellData::parseGetAll_data()
+{
+    QTest::addColumn<bool>("map");
+
+    QTest::newRow("in place") << false;
+    QTest::newRow("QVariantMap") << true;
+}
+
+void BenchCellData::parseGetAll()
+{
+    QFETCH(bool, map);
+    const int n = 10000;
+    int props[QOfonoExtCell::PropertyCount];
+    qint64 nci;
+
+    // Each copy of the argument reads from the start of the dictionary
+    TestMetrics metrics;
+    for (int i = 0; i < n; i++) {
+        if (map) {
+            mapParseProperties(qdbus_cast<QVariantMap>(iGetAllProperties),
+                props, &nci);
+        } else {
+            QOfonoExtCellData::Private::parseProperties(
+                qvariant_cast<QDBusArgument>(iGetAllProperties), props, &nci);
+        }
+    }
+    QCOMPARE(props[QOfonoExtCell::PropertyRsrp], 90);
+
+    QByteArray label("Cell.GetAll properties per parse, ");
+    label.append(QTest::currentDataTag());
+    metrics.report(label.constData(), n);
+}
+
+TESTBUS_MAIN(BenchCellData)
+
+#include "bench_celldata.moc"
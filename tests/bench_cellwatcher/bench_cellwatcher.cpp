@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include <QtTest>
+
+#include "testbus.h"
+#include "testmetrics.h"
+#include "mockofono.h"
+
+#include "qofonoextcellwatcher.h"
+
+// Two modems, each seeing a serving cell and a bunch of neighbours
+#define MODEM_COUNT 2
+#define CELLS_PER_MODEM 16
+
+class BenchCellWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    BenchCellWatcher();
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void timeToValid();
+    void updates();
+    void addRemove();
+
+private:
+    static bool allValid(const QOfonoExtCellWatcher* aWatcher, int aCount);
+    static bool allEqual(const QOfonoExtCellWatcher* aWatcher, int aRsrp);
+
+private:
+    MockOfono* iMock;
+    QStringList iModems;
+    QStringList iCells;
+    int iNextValue;
+};
+
+BenchCellWatcher::BenchCellWatcher() :
+    iMock(Q_NULLPTR),
+    iNextValue(44)
+{
+}
+
+bool BenchCellWatcher::allValid(const QOfonoExtCellWatcher* aWatcher, int aCount)
+{
+    const QList<QSharedPointer<QOfonoExtCell> > cells(aWatcher->cells());
+    if (cells.count() != aCount) {
+        return false;
+    }
+    for (int i = 0; i < cells.count(); i++) {
+        if (!cells.at(i)->valid()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BenchCellWatcher::allEqual(const QOfonoExtCellWatcher* aWatcher, int aRsrp)
+{
+    const QList<QSharedPointer<QOfonoExtCell> > cells(aWatcher->cells());
+    for (int i = 0; i < cells.count(); i++) {
+        if (cells.at(i)->rsrp() != aRsrp) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BenchCellWatcher::initTestCase()
+{
+    iMock = new MockOfono;
+    QVERIFY(iMock->start(TestBus::systemBusAddress()));
+    for (int m = 0; m < MODEM_COUNT; m++) {
+        const QString modem(QString("/ril_%1").arg(m));
+        iMock->addModem(modem, QString("35000000000000%1").arg(m),
+            QString("24491000000000%1").arg(m));
+        for (int c = 0; c < CELLS_PER_MODEM; c++) {
+            iCells.append(iMock->addCell(modem, MockOfono::Cell("lte", !c,
+                MockOfono::lteProperties(1000 * m + c, 90))));
+        }
+        iModems.append(modem);
+    }
+}
+
+void BenchCellWatcher::cleanupTestCase()
+{
+    delete iMock;
+    iMock = Q_NULLPTR;
+}
+
+void BenchCellWatcher::timeToValid()
+{
+    const int n = 10;
+    const int count = iCells.count();
+    TestMetrics metrics;
+
+    iMock->resetCallCounts();
+    for (int i = 0; i < n; i++) {
+        QOfonoExtCellWatcher* watcher = new QOfonoExtCellWatcher;
+        QVERIFY(TestMetrics::waitFor([watcher,count]() {
+            return allValid(watcher, count); }));
+        delete watcher;
+        QCoreApplication::sendPostedEvents(Q_NULLPTR, QEvent::DeferredDelete);
+    }
+
+    metrics.report("QOfonoExtCellWatcher time-to-valid", n);
+    qInfo("%d D-Bus calls per watcher with %d cells",
+        iMock->totalCallCount() / n, count);
+}
+
+void BenchCellWatcher::updates()
+{
+    const int rounds = 100;
+    const int n = rounds * iCells.count();
+    QOfonoExtCellWatcher watcher;
+    const int count = iCells.count();
+    QVERIFY(TestMetrics::waitFor([&watcher,count]() {
+        return allValid(&watcher, count); }));
+
+    QSignalSpy spy(&watcher, SIGNAL(cellUpdated(QSharedPointer<QOfonoExtCell>)));
+    const int last = iNextValue + rounds - 1;
+    TestMetrics metrics;
+
+    iMock->storm(iCells, "rsrp", rounds, iNextValue);
+    iNextValue += rounds;
+    QVERIFY(TestMetrics::waitFor([&watcher,last]() {
+        return allEqual(&watcher, last); }, 30000));
+
+    metrics.report("QOfonoExtCellWatcher per update", n);
+    qInfo("cellUpdated emitted %d times for %d updates", spy.count(), n);
+}
+
+void BenchCellWatcher::addRemove()
+{
+    // Neighbours coming and going, as when moving around
+    const int n = 50;
+    const int batch = 4;
+    const QString modem(iModems.first());
+    QOfonoExtCellWatcher watcher;
+    const int count = iCells.count();
+    QVERIFY(TestMetrics::waitFor([&watcher,count]() {
+        return allValid(&watcher, count); }));
+
+    TestMetrics metrics;
+    for (int i = 0; i < n; i++) {
+        QList<MockOfono::Cell> cells;
+        for (int c = 0; c < batch; c++) {
+            cells.append(MockOfono::Cell("lte", false,
+                MockOfono::lteProperties(5000 + c, 100)));
+        }
+
+        const QStringList added(iMock->addCells(modem, cells));
+        QVERIFY(TestMetrics::waitFor([&watcher,count,batch]() {
+            return allValid(&watcher, count + batch); }));
+
+        iMock->removeCells(modem, added);
+        QVERIFY(TestMetrics::waitFor([&watcher,count]() {
+            return watcher.cells().count() == count; }));
+    }
+
+    metrics.report("QOfonoExtCellWatcher per add+remove of 4 cells", n);
+}
+
+TESTBUS_MAIN(BenchCellWatcher)
+
+#include "bench_cellwatcher.moc"
@@ -0,0 +1,216 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include <QtTest>
+
+#include "testbus.h"
+#include "testmetrics.h"
+#include "mockofono.h"
+
+#include "qofonoextmodemlistmodel.h"
+#include "qofonoextsimlistmodel.h"
+
+// A view creates a delegate for each inserted row and for every row
+// after a reset. Moved rows keep theirs.
+class DelegateCounter : public QObject
+{
+    Q_OBJECT
+
+public:
+    DelegateCounter(QAbstractItemModel* aModel) :
+        QObject(aModel), iCount(0), iModel(aModel)
+    {
+        connect(aModel, SIGNAL(rowsInserted(QModelIndex,int,int)),
+            SLOT(onRowsInserted(QModelIndex,int,int)));
+        connect(aModel, SIGNAL(modelReset()), SLOT(onModelReset()));
+    }
+
+    int iCount;
+
+private Q_SLOTS:
+    void onRowsInserted(const QModelIndex&, int aFirst, int aLast)
+        { iCount += aLast - aFirst + 1; }
+    void onModelReset()
+        { iCount += iModel->rowCount(); }
+
+private:
+    QAbstractItemModel* iModel;
+};
+
+class BenchModels : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void modemHotplug_data();
+    void modemHotplug();
+    void simData_data();
+    void simData();
+
+private:
+    static int readAll(const QAbstractItemModel* aModel);
+    static QStringList modems(const char* aIndices);
+    static QStringList rows(const QAbstractItemModel* aModel);
+    static void setModems(QObject* aModel, QStringList aModems);
+
+private:
+    MockOfono* iMock;
+};
+
+QStringList BenchModels::modems(const char* aIndices)
+{
+    QStringList list;
+    for (const char* c = aIndices; *c; c++) {
+        list.append(QString("/ril_%1").arg(QLatin1Char(*c)));
+    }
+    return list;
+}
+
+QStringList BenchModels::rows(const QAbstractItemModel* aModel)
+{
+    QStringList list;
+    const int n = aModel->rowCount();
+    for (int i = 0; i < n; i++) {
+        list.append(aModel->data(aModel->index(i, 0),
+            QOfonoExtModemListModel::PathRole).toString());
+    }
+    return list;
+}
+
+void BenchModels::setModems(QObject* aModel, QStringList aModems)
+{
+    // What the model does when QOfonoExtModemManager reports a change
+    QMetaObject::invokeMethod(aModel, "onAvailableModemsChanged",
+        Q_ARG(QStringList, aModems));
+}
+
+void BenchModels::initTestCase()
+{
+    iMock = new MockOfono;
+    QVERIFY(iMock->start(TestBus::systemBusAddress()));
+    iMock->addModem("/ril_0", "350000000000001", "244910000000001");
+    iMock->addModem("/ril_1", "350000000000002", "244910000000002");
+}
+
+void BenchModels::cleanupTestCase()
+{
+    delete iMock;
+    iMock = Q_NULLPTR;
+}
+
+void BenchModels::modemHotplug_data()
+{
+    QTest::addColumn<QString>("before");
+    QTest::addColumn<QString>("after");
+
+    QTest::newRow("add") << "0123567" << "01234567";
+    QTest::newRow("remove") << "01234567" << "0123567";
+    QTest::newRow("reorder") << "01234567" << "01274563";
+    QTest::newRow("no change") << "01234567" << "01234567";
+}
+
+void BenchModels::modemHotplug()
+{
+    QFETCH(QString, before);
+    QFETCH(QString, after);
+    const int n = 100;
+    const QStringList from(modems(before.toLatin1().constData()));
+    const QStringList to(modems(after.toLatin1().constData()));
+
+    QOfonoExtModemListModel model;
+    QVERIFY(TestMetrics::waitFor([&model]() { return model.valid(); }));
+    DelegateCounter* counter = new DelegateCounter(&model);
+    int delegates = 0;
+
+    TestMetrics metrics;
+    for (int i = 0; i < n; i++) {
+        setModems(&model, from);
+        counter->iCount = 0;
+        setModems(&model, to);
+        delegates += counter->iCount;
+    }
+    QCOMPARE(rows(&model), to);
+
+    QByteArray label("QOfonoExtModemListModel per 2 changes, ");
+    label.append(QTest::currentDataTag());
+    metrics.report(label.constData(), n);
+    qInfo("%.1f delegates created per change, a reset would create %d",
+        double(delegates) / n, to.count());
+}
+
+void BenchModels::simData_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    // A delegate reads every role once when it's created, bindings
+    // read them again whenever they get re-evaluated
+    QTest::newRow("first read") << false;
+    QTest::newRow("cached") << true;
+}
+
+int BenchModels::readAll(const QAbstractItemModel* aModel)
+{
+    int valid = 0;
+    const int n = aModel->rowCount();
+    for (int i = 0; i < n; i++) {
+        const QModelIndex index(aModel->index(i, 0));
+        for (int role = QOfonoExtSimListModel::FirstRole;
+             role <= QOfonoExtSimListModel::LastRole; role++) {
+            valid += aModel->data(index, role).isValid();
+        }
+    }
+    return valid;
+}
+
+void BenchModels::simData()
+{
+    QFETCH(bool, cached);
+    const int n = 50;
+    const int roles = QOfonoExtSimListModel::LastRole -
+        QOfonoExtSimListModel::FirstRole + 1;
+
+    // The first read builds the values, so each pass needs its own model
+    QList<QSharedPointer<QOfonoExtSimListModel> > models;
+    for (int i = 0; i < (cached ? 1 : n); i++) {
+        models.append(QSharedPointer<QOfonoExtSimListModel>
+            (new QOfonoExtSimListModel));
+    }
+    QVERIFY(TestMetrics::waitFor([&models]() {
+        for (int i = 0; i < models.count(); i++) {
+            if (!models.at(i)->valid() || models.at(i)->count() != 2) {
+                return false;
+            }
+        }
+        return true; }));
+    if (cached) {
+        readAll(models.first().data());
+    }
+
+    int valid = 0;
+    TestMetrics metrics;
+    for (int i = 0; i < n; i++) {
+        valid += readAll(models.at(cached ? 0 : i).data());
+    }
+    QVERIFY(valid > 0);
+
+    QByteArray label("QOfonoExtSimListModel per data(), ");
+    label.append(QTest::currentDataTag());
+    metrics.report(label.constData(), n * 2 * roles);
+}
+
+TESTBUS_MAIN(BenchModels)
+
+#include "bench_models.moc"
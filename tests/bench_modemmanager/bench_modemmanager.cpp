@@ -0,0 +1,118 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include <QtTest>
+
+#include "testbus.h"
+#include "testmetrics.h"
+#include "mockofono.h"
+
+#include "qofonoextmodemmanager.h"
+
+class BenchModemManager : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void timeToValid_data();
+    void timeToValid();
+    void updates();
+
+private:
+    MockOfono* iMock;
+};
+
+void BenchModemManager::initTestCase()
+{
+    iMock = new MockOfono;
+    QVERIFY(iMock->start(TestBus::systemBusAddress()));
+    iMock->addModem("/ril_0", "350000000000001", "244910000000001");
+    iMock->addModem("/ril_1", "350000000000002", "244910000000002");
+}
+
+void BenchModemManager::cleanupTestCase()
+{
+    delete iMock;
+    iMock = Q_NULLPTR;
+}
+
+void BenchModemManager::timeToValid_data()
+{
+    QTest::addColumn<int>("version");
+    QTest::addColumn<int>("delay");
+
+    // The latest ofono answers the first GetAll8. An older one rejects
+    // it, and then it takes GetInterfaceVersion and GetAllN. The delay
+    // stands for a busy system bus, where round trips dominate.
+    QTest::newRow("v8") << 8 << 0;
+    QTest::newRow("v5") << 5 << 0;
+    QTest::newRow("v8, 20 ms replies") << 8 << 20;
+    QTest::newRow("v5, 20 ms replies") << 5 << 20;
+}
+
+void BenchModemManager::timeToValid()
+{
+    QFETCH(int, version);
+    QFETCH(int, delay);
+    const int n = 20;
+
+    iMock->setInterfaceVersion(version);
+    iMock->setReplyDelay(delay);
+    iMock->resetCallCounts();
+
+    TestMetrics metrics;
+    for (int i = 0; i < n; i++) {
+        QOfonoExtModemManager* manager = new QOfonoExtModemManager;
+        QVERIFY(TestMetrics::waitFor([manager]() { return manager->valid(); }));
+        QCOMPARE(manager->interfaceVersion(), version);
+        delete manager;
+    }
+
+    QByteArray label("QOfonoExtModemManager time-to-valid, ");
+    label.append(QTest::currentDataTag());
+    metrics.report(label.constData(), n);
+    qInfo("%.1f calls per manager, of which %.1f GetInterfaceVersion",
+        double(iMock->totalCallCount()) / n, double(iMock->callCount(
+        "org.nemomobile.ofono.ModemManager", "GetInterfaceVersion")) / n);
+
+    iMock->setInterfaceVersion(8);
+    iMock->setReplyDelay(0);
+}
+
+void BenchModemManager::updates()
+{
+    const int n = 1000;
+    QOfonoExtModemManager manager;
+    QVERIFY(TestMetrics::waitFor([&manager]() { return manager.valid(); }));
+
+    // Queue the whole storm first, so that only the receiving end is
+    // charged to this thread. Each value is different, the last one to
+    // arrive tells that all of them have been handled.
+    QString imsi;
+    for (int i = 0; i < n; i++) {
+        imsi = QString("24491%1").arg(i, 10, 10, QChar('0'));
+        iMock->emitManagerSignal("DefaultDataSimChanged", QVariantList() << imsi);
+    }
+
+    TestMetrics metrics;
+    QVERIFY(TestMetrics::waitFor([&manager,imsi]() {
+        return manager.defaultDataSim() == imsi; }));
+    metrics.report("QOfonoExtModemManager per update", n);
+}
+
+TESTBUS_MAIN(BenchModemManager)
+
+#include "bench_modemmanager.moc"
@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include <QtTest>
+
+#include "testbus.h"
+#include "testmetrics.h"
+#include "mockofono.h"
+
+#include "qofonoext_p.h"
+
+#define MODEM_PATH "/ril_0"
+#define CELL_COUNT 32
+#define CELL_INTERFACE "org.nemomobile.ofono.Cell"
+
+// What the cell proxy used to be
+class OldCellProxy : public QDBusAbstractInterface
+{
+public:
+    OldCellProxy(const QString& aPath, QObject* aParent) :
+        QDBusAbstractInterface(OFONO_SERVICE, aPath, CELL_INTERFACE,
+            OFONO_BUS, aParent) {}
+};
+
+class BenchProxy : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void construct_data();
+    void construct();
+
+private:
+    MockOfono* iMock;
+    QStringList iCells;
+};
+
+void BenchProxy::initTestCase()
+{
+    iMock = new MockOfono;
+    QVERIFY(iMock->start(TestBus::systemBusAddress()));
+    iMock->addModem(MODEM_PATH, "350000000000001", "244910000000001");
+    for (int i = 0; i < CELL_COUNT; i++) {
+        iCells.append(iMock->addCell(MODEM_PATH, MockOfono::Cell("lte",
+            !i, MockOfono::lteProperties(1000 + i, 100))));
+    }
+}
+
+void BenchProxy::cleanupTestCase()
+{
+    delete iMock;
+    iMock = Q_NULLPTR;
+}
+
+void BenchProxy::construct_data()
+{
+    QTest::addColumn<bool>("old");
+
+    QTest::newRow("QOfonoExtProxy") << false;
+    QTest::newRow("QDBusAbstractInterface") << true;
+}
+
+void BenchProxy::construct()
+{
+    // A watcher creating a proxy per cell and asking each for GetAll.
+    // QDBusAbstractInterface looks up the name owner with a blocking
+    // call to the bus daemon, which the mock doesn't see but the wall
+    // time does.
+    QFETCH(bool, old);
+    const int rounds = 10;
+    const int n = iCells.count();
+    int replies = 0;
+
+    TestMetrics build, total;
+    qint64 buildNs = 0, buildCpuNs = 0;
+    for (int r = 0; r < rounds; r++) {
+        QObject parent;
+        QList<QDBusPendingCall> calls;
+
+        build.restart();
+        for (int i = 0; i < n; i++) {
+            if (old) {
+                OldCellProxy* proxy = new OldCellProxy(iCells.at(i), &parent);
+                calls.append(proxy->asyncCall("GetAll"));
+            } else {
+                QOfonoExtProxy* proxy = new QOfonoExtProxy(iCells.at(i),
+                    CELL_INTERFACE, &parent);
+                calls.append(proxy->asyncCall("GetAll"));
+            }
+        }
+        buildNs += build.wallNs();
+        buildCpuNs += build.cpuNs();
+
+        QVERIFY(TestMetrics::waitFor([&calls]() {
+            for (int i = 0; i < calls.count(); i++) {
+                if (!calls.at(i).isFinished()) return false;
+            }
+            return true; }));
+        for (int i = 0; i < calls.count(); i++) {
+            replies += !calls.at(i).isError();
+        }
+    }
+    QCOMPARE(replies, rounds * n);
+
+    QByteArray label("Cell proxy construct + GetAll reply, ");
+    label.append(QTest::currentDataTag());
+    total.report(label.constData(), rounds * n);
+    qInfo("construction alone: wall %.1f us, cpu %.1f us per proxy",
+        buildNs / 1000.0 / (rounds * n), buildCpuNs / 1000.0 / (rounds * n));
+}
+
+TESTBUS_MAIN(BenchProxy)
+
+#include "bench_proxy.moc"
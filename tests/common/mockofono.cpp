@@ -0,0 +1,647 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include "mockofono.h"
+
+#include <QtDBus>
+
+#define OFONO_SERVICE "org.ofono"
+#define OFONO_MANAGER_INTERFACE "org.ofono.Manager"
+#define OFONO_MODEM_INTERFACE "org.ofono.Modem"
+#define OFONO_SIM_MANAGER_INTERFACE "org.ofono.SimManager"
+#define OFONO_MODEM_MANAGER_INTERFACE "org.nemomobile.ofono.ModemManager"
+#define OFONO_CELL_INFO_INTERFACE "org.nemomobile.ofono.CellInfo"
+#define OFONO_CELL_INTERFACE "org.nemomobile.ofono.Cell"
+#define OFONO_SIM_INFO_INTERFACE "org.nemomobile.ofono.SimInfo"
+
+#define DBUS_ERROR_UNKNOWN_METHOD "org.freedesktop.DBus.Error.UnknownMethod"
+#define DBUS_ERROR_UNKNOWN_OBJECT "org.freedesktop.DBus.Error.UnknownObject"
+
+// a(oa{sv}) element, as returned by org.ofono.Manager.GetModems
+struct MockModemEntry {
+    QDBusObjectPath iPath;
+    QVariantMap iProperties;
+};
+
+// (si) element of ModemManager error lists
+struct MockError {
+    QString iName;
+    int iCount;
+};
+
+typedef QList<MockModemEntry> MockModemEntryList;
+typedef QList<MockError> MockErrorList;
+typedef QList<MockErrorList> MockModemErrors;
+
+Q_DECLARE_METATYPE(MockModemEntry)
+Q_DECLARE_METATYPE(MockError)
+
+QDBusArgument& operator<<(QDBusArgument& aArg, const MockModemEntry& aValue)
+{
+    aArg.beginStructure();
+    aArg << aValue.iPath << aValue.iProperties;
+    aArg.endStructure();
+    return aArg;
+}
+
+const QDBusArgument& operator>>(const QDBusArgument& aArg, MockModemEntry& aValue)
+{
+    aArg.beginStructure();
+    aArg >> aValue.iPath >> aValue.iProperties;
+    aArg.endStructure();
+    return aArg;
+}
+
+QDBusArgument& operator<<(QDBusArgument& aArg, const MockError& aValue)
+{
+    aArg.beginStructure();
+    aArg << aValue.iName << aValue.iCount;
+    aArg.endStructure();
+    return aArg;
+}
+
+const QDBusArgument& operator>>(const QDBusArgument& aArg, MockError& aValue)
+{
+    aArg.beginStructure();
+    aArg >> aValue.iName >> aValue.iCount;
+    aArg.endStructure();
+    return aArg;
+}
+
+// ==========================================================================
+// MockOfono::Service
+// ==========================================================================
+
+class MockOfono::Service : public QDBusVirtualObject
+{
+    Q_OBJECT
+
+public:
+    struct Modem {
+        Modem() : iNextCell(0) {}
+
+        QString iImei;
+        QString iImsi;
+        QStringList iCells;
+        int iNextCell;
+    };
+
+    Service();
+
+    QString introspect(const QString& aPath) const Q_DECL_OVERRIDE;
+    bool handleMessage(const QDBusMessage& aMessage,
+        const QDBusConnection& aConnection) Q_DECL_OVERRIDE;
+
+    void send(const QDBusMessage& aMessage);
+    QDBusMessage reply(const QDBusMessage& aCall);
+    QVariantMap modemProperties(const QString& aPath) const;
+    QVariantMap simProperties(const QString& aPath) const;
+    static QList<QDBusObjectPath> objectPaths(const QStringList& aPaths);
+    static QString iccid(const QString& aImsi);
+
+public Q_SLOTS:
+    bool connectToBus(QString aAddress);
+    void disconnectFromBus();
+    void storm(QStringList aCells, QString aProperty, int aRounds,
+        int aFirstValue, int aInterval);
+
+public:
+    void stormRound(const QStringList& aCells, const QString& aProperty, int aValue);
+
+    mutable QMutex iMutex;
+    QDBusConnection iBus;
+    int iInterfaceVersion;
+    int iReplyDelay;
+    QStringList iModems;
+    QStringList iEnabledModems;
+    QList<bool> iPresentSims;
+    QHash<QString,Modem> iModemData;
+    QHash<QString,Cell> iCells;
+    QHash<QString,int> iCallCounts;
+    int iTotalCallCount;
+};
+
+MockOfono::Service::Service() :
+    iBus(QString()),
+    iInterfaceVersion(8),
+    iReplyDelay(0),
+    iTotalCallCount(0)
+{
+    qDBusRegisterMetaType<MockModemEntry>();
+    qDBusRegisterMetaType<MockModemEntryList>();
+    qDBusRegisterMetaType<MockError>();
+    qDBusRegisterMetaType<MockErrorList>();
+    qDBusRegisterMetaType<MockModemErrors>();
+    qDBusRegisterMetaType<QList<QDBusObjectPath> >();
+    qDBusRegisterMetaType<QList<bool> >();
+}
+
+bool MockOfono::Service::connectToBus(QString aAddress)
+{
+    iBus = QDBusConnection::connectToBus(aAddress, "mock-ofono");
+    if (!iBus.isConnected()) {
+        qWarning() << "Mock ofono failed to connect to" << aAddress;
+    } else if (!iBus.registerVirtualObject("/", this,
+        QDBusConnection::SubPathRegistration)) {
+        qWarning() << "Mock ofono failed to register the root object";
+    } else if (!iBus.registerService(OFONO_SERVICE)) {
+        qWarning() << "Mock ofono failed to take the service name";
+    } else {
+        return true;
+    }
+    return false;
+}
+
+void MockOfono::Service::disconnectFromBus()
+{
+    if (iBus.isConnected()) {
+        iBus.unregisterService(OFONO_SERVICE);
+        iBus.unregisterObject("/", QDBusConnection::UnregisterTree);
+        iBus = QDBusConnection(QString());
+        QDBusConnection::disconnectFromBus("mock-ofono");
+    }
+}
+
+QString MockOfono::Service::introspect(const QString&) const
+{
+    return QString();
+}
+
+void MockOfono::Service::send(const QDBusMessage& aMessage)
+{
+    iBus.send(aMessage);
+}
+
+bool MockOfono::Service::handleMessage(const QDBusMessage& aMessage,
+    const QDBusConnection&)
+{
+    if (aMessage.type() != QDBusMessage::MethodCallMessage) {
+        return false;
+    }
+
+    QMutexLocker lock(&iMutex);
+    const QDBusMessage response(reply(aMessage));
+    const int delay = iReplyDelay;
+
+    iCallCounts[aMessage.interface() + QChar('.') + aMessage.member()]++;
+    iTotalCallCount++;
+    lock.unlock();
+
+    aMessage.setDelayedReply(true);
+    if (delay > 0) {
+        QTimer::singleShot(delay, this, [this,response]() { send(response); });
+    } else {
+        send(response);
+    }
+    return true;
+}
+
+// Called with the mutex locked
+QDBusMessage MockOfono::Service::reply(const QDBusMessage& aCall)
+{
+    const QString path(aCall.path());
+    const QString iface(aCall.interface());
+    const QString method(aCall.member());
+    const QList<QVariant> args(aCall.arguments());
+
+    if (path == QLatin1String("/")) {
+        if (iface == QLatin1String(OFONO_MANAGER_INTERFACE)) {
+            if (method == QLatin1String("GetModems")) {
+                MockModemEntryList modems;
+                for (int i = 0; i < iModems.count(); i++) {
+                    MockModemEntry entry;
+                    entry.iPath = QDBusObjectPath(iModems.at(i));
+                    entry.iProperties = modemProperties(iModems.at(i));
+                    modems.append(entry);
+                }
+                return aCall.createReply(QVariant::fromValue(modems));
+            }
+        } else if (iface == QLatin1String(OFONO_MODEM_MANAGER_INTERFACE)) {
+            if (method == QLatin1String("GetInterfaceVersion")) {
+                return aCall.createReply(iInterfaceVersion);
+            } else if (method.startsWith(QLatin1String("GetAll"))) {
+                const int version = (method.length() == 6) ? 1 : method.mid(6).toInt();
+                if (version > 0 && version <= iInterfaceVersion) {
+                    QStringList imeis, imeisvs;
+                    QString dataSim, dataModem;
+                    MockModemErrors modemErrors;
+                    for (int i = 0; i < iModems.count(); i++) {
+                        const Modem modem(iModemData.value(iModems.at(i)));
+                        imeis.append(modem.iImei);
+                        imeisvs.append(QString("01"));
+                        modemErrors.append(MockErrorList());
+                        if (dataModem.isEmpty() && !modem.iImsi.isEmpty() &&
+                            iEnabledModems.contains(iModems.at(i))) {
+                            dataSim = modem.iImsi;
+                            dataModem = iModems.at(i);
+                        }
+                    }
+
+                    QDBusMessage response(aCall.createReply());
+                    response << iInterfaceVersion <<
+                        QVariant::fromValue(objectPaths(iModems)) <<
+                        QVariant::fromValue(objectPaths(iEnabledModems)) <<
+                        dataSim << dataSim << dataModem << dataModem;
+                    if (version >= 2) {
+                        response << QVariant::fromValue(iPresentSims);
+                    }
+                    if (version >= 3) {
+                        response << imeis;
+                    }
+                    if (version >= 4) {
+                        response << dataSim << dataModem;
+                    }
+                    if (version >= 5) {
+                        response << true;
+                    }
+                    if (version >= 6) {
+                        response << QVariant::fromValue(modemErrors);
+                    }
+                    if (version >= 7) {
+                        response << imeisvs;
+                    }
+                    if (version >= 8) {
+                        response << QVariant::fromValue(MockErrorList());
+                    }
+                    return response;
+                }
+            } else if (method == QLatin1String("SetEnabledModems")) {
+                iEnabledModems.clear();
+                const QList<QDBusObjectPath> paths(qdbus_cast<QList<QDBusObjectPath> >(args.value(0)));
+                for (int i = 0; i < paths.count(); i++) {
+                    iEnabledModems.append(paths.at(i).path());
+                }
+                send(QDBusMessage::createSignal("/", OFONO_MODEM_MANAGER_INTERFACE,
+                    "EnabledModemsChanged") << QVariant::fromValue(paths));
+                return aCall.createReply();
+            } else if (method == QLatin1String("SetDefaultDataSim") ||
+                method == QLatin1String("SetDefaultVoiceSim")) {
+                return aCall.createReply();
+            }
+        }
+    } else if (iModemData.contains(path)) {
+        const Modem& modem(iModemData[path]);
+        if (iface == QLatin1String(OFONO_MODEM_INTERFACE)) {
+            if (method == QLatin1String("GetProperties")) {
+                return aCall.createReply(modemProperties(path));
+            }
+        } else if (iface == QLatin1String(OFONO_SIM_MANAGER_INTERFACE)) {
+            if (method == QLatin1String("GetProperties")) {
+                return aCall.createReply(simProperties(path));
+            }
+        } else if (iface == QLatin1String(OFONO_CELL_INFO_INTERFACE)) {
+            if (method == QLatin1String("GetCells")) {
+                return aCall.createReply(QVariant::fromValue(objectPaths(modem.iCells)));
+            }
+        } else if (iface == QLatin1String(OFONO_SIM_INFO_INTERFACE)) {
+            if (method == QLatin1String("GetAll")) {
+                QDBusMessage response(aCall.createReply());
+                response << 1 << iccid(modem.iImsi) << modem.iImsi <<
+                    QString(modem.iImsi.isEmpty() ? "" : "Mock");
+                return response;
+            }
+        }
+    } else if (iCells.contains(path)) {
+        if (iface == QLatin1String(OFONO_CELL_INTERFACE) &&
+            method == QLatin1String("GetAll")) {
+            const Cell& cell(iCells[path]);
+            QDBusMessage response(aCall.createReply());
+            response << 1 << cell.iType << cell.iRegistered << cell.iProperties;
+            return response;
+        }
+    } else {
+        return aCall.createErrorReply(DBUS_ERROR_UNKNOWN_OBJECT, path);
+    }
+    return aCall.createErrorReply(DBUS_ERROR_UNKNOWN_METHOD, iface +
+        QChar('.') + method);
+}
+
+QVariantMap MockOfono::Service::modemProperties(const QString& aPath) const
+{
+    QVariantMap props;
+    props.insert("Powered", true);
+    props.insert("Online", true);
+    props.insert("Emergency", false);
+    props.insert("Lockdown", false);
+    props.insert("Type", QString("hardware"));
+    props.insert("Name", QString());
+    props.insert("Manufacturer", QString("Mock"));
+    props.insert("Model", QString("Mock"));
+    props.insert("Revision", QString("1"));
+    props.insert("Serial", iModemData.value(aPath).iImei);
+    props.insert("Features", QStringList() << "sim");
+    props.insert("Interfaces", QStringList() <<
+        OFONO_SIM_MANAGER_INTERFACE <<
+        OFONO_CELL_INFO_INTERFACE <<
+        OFONO_SIM_INFO_INTERFACE);
+    return props;
+}
+
+QVariantMap MockOfono::Service::simProperties(const QString& aPath) const
+{
+    const QString imsi(iModemData.value(aPath).iImsi);
+    QVariantMap props;
+    props.insert("Present", !imsi.isEmpty());
+    if (!imsi.isEmpty()) {
+        props.insert("SubscriberIdentity", imsi);
+        props.insert("CardIdentifier", iccid(imsi));
+        props.insert("MobileCountryCode", imsi.left(3));
+        props.insert("MobileNetworkCode", imsi.mid(3, 2));
+        props.insert("PinRequired", QString("none"));
+        props.insert("LockedPins", QStringList());
+        props.insert("SubscriberNumbers", QStringList());
+        props.insert("PreferredLanguages", QStringList());
+        props.insert("FixedDialing", false);
+        props.insert("BarredDialing", false);
+    }
+    return props;
+}
+
+QList<QDBusObjectPath> MockOfono::Service::objectPaths(const QStringList& aPaths)
+{
+    QList<QDBusObjectPath> paths;
+    paths.reserve(aPaths.count());
+    for (int i = 0; i < aPaths.count(); i++) {
+        paths.append(QDBusObjectPath(aPaths.at(i)));
+    }
+    return paths;
+}
+
+QString MockOfono::Service::iccid(const QString& aImsi)
+{
+    return aImsi.isEmpty() ? QString() : (QString("8935") + aImsi);
+}
+
+void MockOfono::Service::storm(QStringList aCells, QString aProperty,
+    int aRounds, int aFirstValue, int aInterval)
+{
+    for (int r = 0; r < aRounds; r++) {
+        stormRound(aCells, aProperty, aFirstValue + r);
+        if (aInterval > 0 && r + 1 < aRounds) {
+            // Keep serving method calls between the rounds
+            QTimer::singleShot(aInterval, this, [=]() {
+                storm(aCells, aProperty, aRounds - r - 1, aFirstValue + r + 1,
+                    aInterval);
+            });
+            break;
+        }
+    }
+}
+
+void MockOfono::Service::stormRound(const QStringList& aCells,
+    const QString& aProperty, int aValue)
+{
+    for (int i = 0; i < aCells.count(); i++) {
+        const QString& path(aCells.at(i));
+        QMutexLocker lock(&iMutex);
+        if (iCells.contains(path)) {
+            iCells[path].iProperties.insert(aProperty, aValue);
+            lock.unlock();
+            send(QDBusMessage::createSignal(path, OFONO_CELL_INTERFACE,
+                "PropertyChanged") << aProperty <<
+                QVariant::fromValue(QDBusVariant(aValue)));
+        }
+    }
+}
+
+// ==========================================================================
+// MockOfono
+// ==========================================================================
+
+MockOfono::Cell::Cell() :
+    iRegistered(false)
+{
+}
+
+MockOfono::Cell::Cell(QString aType, bool aRegistered, QVariantMap aProperties) :
+    iType(aType),
+    iRegistered(aRegistered),
+    iProperties(aProperties)
+{
+}
+
+MockOfono::MockOfono(QObject* aParent) :
+    QObject(aParent),
+    iThread(new QThread(this)),
+    iService(new Service)
+{
+    iService->moveToThread(iThread);
+    iThread->start();
+}
+
+MockOfono::~MockOfono()
+{
+    QMetaObject::invokeMethod(iService, "disconnectFromBus",
+        Qt::BlockingQueuedConnection);
+    iThread->quit();
+    iThread->wait();
+    delete iService;
+}
+
+bool MockOfono::start(QString aAddress)
+{
+    bool ok = false;
+    QMetaObject::invokeMethod(iService, "connectToBus",
+        Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, ok),
+        Q_ARG(QString, aAddress));
+    return ok;
+}
+
+void MockOfono::setInterfaceVersion(int aVersion)
+{
+    QMutexLocker lock(&iService->iMutex);
+    iService->iInterfaceVersion = aVersion;
+}
+
+void MockOfono::setReplyDelay(int aMilliseconds)
+{
+    QMutexLocker lock(&iService->iMutex);
+    iService->iReplyDelay = aMilliseconds;
+}
+
+void MockOfono::addModem(QString aPath, QString aImei, QString aImsi)
+{
+    QMutexLocker lock(&iService->iMutex);
+    if (!iService->iModems.contains(aPath)) {
+        iService->iModems.append(aPath);
+        iService->iEnabledModems.append(aPath);
+        iService->iPresentSims.append(!aImsi.isEmpty());
+    }
+    Service::Modem& modem(iService->iModemData[aPath]);
+    modem.iImei = aImei;
+    modem.iImsi = aImsi;
+}
+
+QString MockOfono::addCell(QString aModemPath, Cell aCell)
+{
+    QMutexLocker lock(&iService->iMutex);
+    Service::Modem& modem(iService->iModemData[aModemPath]);
+    const QString path(cellPath(aModemPath, modem.iNextCell++));
+    modem.iCells.append(path);
+    iService->iCells.insert(path, aCell);
+    return path;
+}
+
+int MockOfono::callCount(QString aInterface, QString aMethod) const
+{
+    QMutexLocker lock(&iService->iMutex);
+    return iService->iCallCounts.value(aInterface + QChar('.') + aMethod);
+}
+
+int MockOfono::totalCallCount() const
+{
+    QMutexLocker lock(&iService->iMutex);
+    return iService->iTotalCallCount;
+}
+
+void MockOfono::resetCallCounts()
+{
+    QMutexLocker lock(&iService->iMutex);
+    iService->iCallCounts.clear();
+    iService->iTotalCallCount = 0;
+}
+
+// Queued to the mock thread, returns immediately. Each round sets
+// aProperty of every cell in aCells to aFirstValue + round, so after
+// the storm all of them have aFirstValue + aRounds - 1. The rounds are
+// aInterval milliseconds apart, or back to back if it's zero.
+void MockOfono::storm(QStringList aCells, QString aProperty, int aRounds,
+    int aFirstValue, int aInterval)
+{
+    QMetaObject::invokeMethod(iService, "storm", Qt::QueuedConnection,
+        Q_ARG(QStringList, aCells), Q_ARG(QString, aProperty),
+        Q_ARG(int, aRounds), Q_ARG(int, aFirstValue), Q_ARG(int, aInterval));
+}
+
+void MockOfono::emitManagerSignal(QString aName, QVariantList aArgs)
+{
+    QDBusMessage signal(QDBusMessage::createSignal("/",
+        OFONO_MODEM_MANAGER_INTERFACE, aName));
+    signal.setArguments(aArgs);
+    iService->send(signal);
+}
+
+QStringList MockOfono::addCells(QString aModemPath, QList<Cell> aCells)
+{
+    QStringList paths;
+    for (int i = 0; i < aCells.count(); i++) {
+        paths.append(addCell(aModemPath, aCells.at(i)));
+    }
+    iService->send(QDBusMessage::createSignal(aModemPath,
+        OFONO_CELL_INFO_INTERFACE, "CellsAdded") <<
+        QVariant::fromValue(Service::objectPaths(paths)));
+    return paths;
+}
+
+void MockOfono::removeCells(QString aModemPath, QStringList aCells)
+{
+    QMutexLocker lock(&iService->iMutex);
+    Service::Modem& modem(iService->iModemData[aModemPath]);
+    for (int i = 0; i < aCells.count(); i++) {
+        modem.iCells.removeOne(aCells.at(i));
+        iService->iCells.remove(aCells.at(i));
+    }
+    lock.unlock();
+
+    for (int i = 0; i < aCells.count(); i++) {
+        iService->send(QDBusMessage::createSignal(aCells.at(i),
+            OFONO_CELL_INTERFACE, "Removed"));
+    }
+    iService->send(QDBusMessage::createSignal(aModemPath,
+        OFONO_CELL_INFO_INTERFACE, "CellsRemoved") <<
+        QVariant::fromValue(Service::objectPaths(aCells)));
+}
+
+void MockOfono::setPresentSims(QList<bool> aPresent)
+{
+    QMutexLocker lock(&iService->iMutex);
+    const QList<bool> prev(iService->iPresentSims);
+    iService->iPresentSims = aPresent;
+    lock.unlock();
+
+    for (int i = 0; i < aPresent.count(); i++) {
+        if (i >= prev.count() || prev.at(i) != aPresent.at(i)) {
+            iService->send(QDBusMessage::createSignal("/",
+                OFONO_MODEM_MANAGER_INTERFACE, "PresentSimsChanged") <<
+                i << aPresent.at(i));
+        }
+    }
+}
+
+void MockOfono::setModems(QStringList aModems)
+{
+    QMutexLocker lock(&iService->iMutex);
+    const QStringList prev(iService->iModems);
+    QList<MockModemEntry> added;
+    iService->iModems = aModems;
+    for (int i = 0; i < aModems.count(); i++) {
+        const QString& path(aModems.at(i));
+        if (!prev.contains(path)) {
+            MockModemEntry entry;
+            entry.iPath = QDBusObjectPath(path);
+            entry.iProperties = iService->modemProperties(path);
+            added.append(entry);
+        }
+    }
+    lock.unlock();
+
+    for (int i = 0; i < prev.count(); i++) {
+        if (!aModems.contains(prev.at(i))) {
+            iService->send(QDBusMessage::createSignal("/",
+                OFONO_MANAGER_INTERFACE, "ModemRemoved") <<
+                QVariant::fromValue(QDBusObjectPath(prev.at(i))));
+        }
+    }
+    for (int i = 0; i < added.count(); i++) {
+        iService->send(QDBusMessage::createSignal("/",
+            OFONO_MANAGER_INTERFACE, "ModemAdded") <<
+            QVariant::fromValue(added.at(i).iPath) << added.at(i).iProperties);
+    }
+}
+
+void MockOfono::emitEnabledModemsChanged(QStringList aModems)
+{
+    QMutexLocker lock(&iService->iMutex);
+    iService->iEnabledModems = aModems;
+    lock.unlock();
+
+    iService->send(QDBusMessage::createSignal("/",
+        OFONO_MODEM_MANAGER_INTERFACE, "EnabledModemsChanged") <<
+        QVariant::fromValue(Service::objectPaths(aModems)));
+}
+
+QString MockOfono::cellPath(QString aModemPath, int aIndex)
+{
+    return aModemPath + QString("/cell_") + QString::number(aIndex);
+}
+
+QVariantMap MockOfono::lteProperties(int aCi, int aRsrp)
+{
+    QVariantMap props;
+    props.insert("mcc", 244);
+    props.insert("mnc", 91);
+    props.insert("ci", aCi);
+    props.insert("pci", aCi % 504);
+    props.insert("tac", 4242);
+    props.insert("earfcn", 6300);
+    props.insert("signalStrength", 20);
+    props.insert("rsrp", aRsrp);
+    props.insert("rsrq", 10);
+    props.insert("rssnr", 100);
+    props.insert("cqi", 15);
+    props.insert("timingAdvance", 2);
+    return props;
+}
+
+#include "mockofono.moc"
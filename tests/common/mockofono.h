@@ -0,0 +1,82 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef MOCKOFONO_H
+#define MOCKOFONO_H
+
+#include <QtCore>
+
+// Fake org.ofono service for the benchmarks. Implements just enough of
+// org.ofono.Manager, org.ofono.Modem, org.ofono.SimManager and of the
+// org.nemomobile.ofono ModemManager, CellInfo, Cell and SimInfo interfaces
+// for libqofono and libqofonoext to initialize against it.
+//
+// The service runs on its own thread and its own bus connection, so that
+// blocking calls made by the code under test don't deadlock, and so that
+// the cost of generating signal storms isn't charged to the thread being
+// measured. All public methods may be called from any thread.
+class MockOfono : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Cell {
+        Cell();
+        Cell(QString aType, bool aRegistered, QVariantMap aProperties);
+
+        QString iType;
+        bool iRegistered;
+        QVariantMap iProperties;
+    };
+
+    MockOfono(QObject* aParent = Q_NULLPTR);
+    ~MockOfono();
+
+    // Connects to the bus and takes the org.ofono name
+    bool start(QString aAddress);
+
+    // Initial configuration, normally done before the code under test
+    // starts talking to the service. Changes are not signaled.
+    void setInterfaceVersion(int aVersion);
+    void setReplyDelay(int aMilliseconds);
+    void addModem(QString aPath, QString aImei, QString aImsi);
+    QString addCell(QString aModemPath, Cell aCell);
+
+    // Number of method calls received, keyed by "interface.method"
+    int callCount(QString aInterface, QString aMethod) const;
+    int totalCallCount() const;
+    void resetCallCounts();
+
+    // Runs on the mock thread, see mockofono.cpp
+    void storm(QStringList aCells, QString aProperty, int aRounds,
+        int aFirstValue, int aInterval = 0);
+
+    // The rest send their signals before returning
+    void emitManagerSignal(QString aName, QVariantList aArgs);
+    QStringList addCells(QString aModemPath, QList<Cell> aCells);
+    void removeCells(QString aModemPath, QStringList aCells);
+    void setPresentSims(QList<bool> aPresent);
+    void setModems(QStringList aModems);
+    void emitEnabledModemsChanged(QStringList aModems);
+
+    static QString cellPath(QString aModemPath, int aIndex);
+    static QVariantMap lteProperties(int aCi, int aRsrp);
+
+private:
+    class Service;
+    QThread* iThread;
+    Service* iService;
+};
+
+#endif // MOCKOFONO_H
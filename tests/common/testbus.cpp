@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include "testbus.h"
+
+namespace {
+    // Anyone may own any name and talk to anyone
+    const char kConfig[] =
+        "<!DOCTYPE busconfig PUBLIC \"-//freedesktop//DTD D-Bus Bus Configuration 1.0//EN\"\n"
+        " \"http://www.freedesktop.org/standards/dbus/1.0/busconfig.dtd\">\n"
+        "<busconfig>\n"
+        "  <type>session</type>\n"
+        "  <listen>unix:dir=%1</listen>\n"
+        "  <auth>EXTERNAL</auth>\n"
+        "  <policy context=\"default\">\n"
+        "    <allow send_destination=\"*\" eavesdrop=\"true\"/>\n"
+        "    <allow eavesdrop=\"true\"/>\n"
+        "    <allow own=\"*\"/>\n"
+        "  </policy>\n"
+        "</busconfig>\n";
+}
+
+TestBus::TestBus() :
+    iDaemon(Q_NULLPTR)
+{
+}
+
+TestBus::~TestBus()
+{
+    if (iDaemon) {
+        iDaemon->terminate();
+        if (!iDaemon->waitForFinished(5000)) {
+            iDaemon->kill();
+            iDaemon->waitForFinished();
+        }
+        delete iDaemon;
+    }
+}
+
+QString TestBus::address() const
+{
+    return iAddress;
+}
+
+QString TestBus::systemBusAddress()
+{
+    return QString::fromLocal8Bit(qgetenv("DBUS_SYSTEM_BUS_ADDRESS"));
+}
+
+bool TestBus::start()
+{
+    if (!iDir.isValid()) {
+        qWarning() << "Failed to create temporary directory";
+        return false;
+    }
+
+    const QString config(iDir.filePath("bus.conf"));
+    QFile file(config);
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(QString(kConfig).arg(iDir.path()).toUtf8()) < 0) {
+        qWarning() << "Failed to write" << config;
+        return false;
+    }
+    file.close();
+
+    iDaemon = new QProcess;
+    iDaemon->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    iDaemon->start("dbus-daemon", QStringList() << "--nofork" <<
+        "--print-address" << (QString("--config-file=") + config));
+    if (!iDaemon->waitForStarted()) {
+        qWarning() << "Failed to start dbus-daemon";
+        return false;
+    }
+
+    // The address is the first (and only) line of the output
+    while (!iDaemon->canReadLine()) {
+        if (!iDaemon->waitForReadyRead(10000)) {
+            qWarning() << "dbus-daemon didn't print its address";
+            return false;
+        }
+    }
+    iAddress = QString::fromLocal8Bit(iDaemon->readLine()).trimmed();
+
+    const QByteArray address(iAddress.toLocal8Bit());
+    qputenv("DBUS_SYSTEM_BUS_ADDRESS", address);
+    qputenv("DBUS_SESSION_BUS_ADDRESS", address);
+    qunsetenv("QOFONOEXT_BUS"); // i.e. the system bus
+    return true;
+}
@@ -0,0 +1,57 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef TESTBUS_H
+#define TESTBUS_H
+
+#include <QtCore>
+
+// Private dbus-daemon for the duration of a test run. Both the system
+// and the session bus addresses point to it, so that libqofono (which
+// always uses the system bus) and libqofonoext talk to the mock service
+// rather than to the real ofono. Must be started before anything in the
+// process touches D-Bus.
+class TestBus
+{
+public:
+    TestBus();
+    ~TestBus();
+
+    bool start();
+    QString address() const;
+
+    // The address of the bus started by the last start() call
+    static QString systemBusAddress();
+
+private:
+    QTemporaryDir iDir;
+    QProcess* iDaemon;
+    QString iAddress;
+};
+
+// Starts the private bus before running the test object, since
+// nothing may touch D-Bus before DBUS_SYSTEM_BUS_ADDRESS is set
+#define TESTBUS_MAIN(TestObject) \
+int main(int argc, char *argv[]) \
+{ \
+    QCoreApplication app(argc, argv); \
+    TestBus bus; \
+    if (!bus.start()) { \
+        return 1; \
+    } \
+    TestObject test; \
+    return QTest::qExec(&test, argc, argv); \
+}
+
+#endif // TESTBUS_H
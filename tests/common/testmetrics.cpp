@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include "testmetrics.h"
+
+#include <time.h>
+
+#ifdef __GLIBC__
+
+// Count the allocations made by each thread by wrapping the allocator.
+// Defining these in the executable interposes them for the whole process,
+// including libqofonoext and Qt.
+
+extern "C" {
+void* __libc_malloc(size_t aSize);
+void* __libc_calloc(size_t aCount, size_t aSize);
+void* __libc_realloc(void* aPtr, size_t aSize);
+void __libc_free(void* aPtr);
+}
+
+static __thread qint64 threadAllocationCount = 0;
+
+extern "C" void* malloc(size_t aSize)
+{
+    threadAllocationCount++;
+    return __libc_malloc(aSize);
+}
+
+extern "C" void* calloc(size_t aCount, size_t aSize)
+{
+    threadAllocationCount++;
+    return __libc_calloc(aCount, aSize);
+}
+
+extern "C" void* realloc(void* aPtr, size_t aSize)
+{
+    threadAllocationCount++;
+    return __libc_realloc(aPtr, aSize);
+}
+
+extern "C" void free(void* aPtr)
+{
+    __libc_free(aPtr);
+}
+
+qint64 TestMetrics::threadAllocations()
+{
+    return threadAllocationCount;
+}
+
+#else
+
+qint64 TestMetrics::threadAllocations()
+{
+    return 0;
+}
+
+#endif // __GLIBC__
+
+TestMetrics::TestMetrics()
+{
+    restart();
+}
+
+void TestMetrics::restart()
+{
+    iAllocStart = threadAllocations();
+    iCpuStart = threadCpuNs();
+    iWall.start();
+}
+
+qint64 TestMetrics::wallNs() const
+{
+    return iWall.nsecsElapsed();
+}
+
+qint64 TestMetrics::cpuNs() const
+{
+    return threadCpuNs() - iCpuStart;
+}
+
+qint64 TestMetrics::allocations() const
+{
+    return threadAllocations() - iAllocStart;
+}
+
+void TestMetrics::report(const char* aLabel, int aOps) const
+{
+    // Take all three before formatting anything
+    const qint64 wall = wallNs();
+    const qint64 cpu = cpuNs();
+    const qint64 allocs = allocations();
+
+    if (aOps > 0) {
+        qInfo("%s: wall %.3f ms, cpu %.3f ms, %lld allocs "
+            "(%lld ns cpu, %.1f allocs per op, %d ops)", aLabel,
+            wall / 1e6, cpu / 1e6, allocs, cpu / aOps,
+            double(allocs) / aOps, aOps);
+    } else {
+        qInfo("%s: wall %.3f ms, cpu %.3f ms, %lld allocs", aLabel,
+            wall / 1e6, cpu / 1e6, allocs);
+    }
+}
+
+qint64 TestMetrics::threadCpuNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+bool TestMetrics::waitFor(std::function<bool()> aCondition, int aTimeout)
+{
+    // Block in the event loop rather than spin, so that waiting isn't
+    // charged to the thread as CPU time. Only events can change the
+    // condition, the deadline timer wakes the loop up in the end.
+    QTimer deadline;
+    deadline.setSingleShot(true);
+    deadline.start(aTimeout);
+    while (!aCondition()) {
+        if (!deadline.isActive()) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+        QCoreApplication::sendPostedEvents(Q_NULLPTR, QEvent::DeferredDelete);
+    }
+    return true;
+}
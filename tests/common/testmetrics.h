@@ -0,0 +1,53 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef TESTMETRICS_H
+#define TESTMETRICS_H
+
+#include <QtCore>
+
+#include <functional>
+
+// What the benchmarks measure: wall time, CPU time consumed by the
+// calling thread and the number of heap allocations made by the calling
+// thread. Allocations are only counted with glibc, elsewhere the count
+// stays at zero.
+class TestMetrics
+{
+public:
+    TestMetrics();
+
+    void restart();
+    qint64 wallNs() const;
+    qint64 cpuNs() const;
+    qint64 allocations() const;
+
+    // "<label>: wall <ms> ms, cpu <ms> ms, <n> allocs" plus per-op
+    // values when aOps is positive
+    void report(const char* aLabel, int aOps = 0) const;
+
+    static qint64 threadCpuNs();
+    static qint64 threadAllocations();
+
+    // Processes events until aCondition() returns true or aTimeout
+    // milliseconds pass. Returns the last value of aCondition().
+    static bool waitFor(std::function<bool()> aCondition, int aTimeout = 10000);
+
+private:
+    QElapsedTimer iWall;
+    qint64 iCpuStart;
+    qint64 iAllocStart;
+};
+
+#endif // TESTMETRICS_H
@@ -0,0 +1,240 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include <QtTest>
+
+#include "testbus.h"
+#include "testmetrics.h"
+#include "mockofono.h"
+
+#include "qofonoextcellhistory.h"
+
+#define MODEM_PATH "/ril_0"
+#define INITIAL_RSRP 90
+#define RSRP QOfonoExtCell::PropertyRsrp
+
+class TestCellHistory : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void statistics();
+    void wraparound();
+    void window();
+    void clear();
+
+private:
+    bool setRsrp(QOfonoExtCellHistory* aHistory, int aValue);
+    bool setRsrp(QOfonoExtCellHistory* aHistory, QList<int> aValues);
+
+private:
+    MockOfono* iMock;
+    QString iCellPath;
+};
+
+void TestCellHistory::initTestCase()
+{
+    iMock = new MockOfono;
+    QVERIFY(iMock->start(TestBus::systemBusAddress()));
+    iMock->addModem(MODEM_PATH, "350000000000001", "244910000000001");
+    iCellPath = iMock->addCell(MODEM_PATH, MockOfono::Cell("lte", true,
+        MockOfono::lteProperties(1000, INITIAL_RSRP)));
+}
+
+void TestCellHistory::cleanupTestCase()
+{
+    delete iMock;
+    iMock = Q_NULLPTR;
+}
+
+// Each value has to differ from the previous one, otherwise the cell
+// doesn't report a change and no sample gets recorded
+bool TestCellHistory::setRsrp(QOfonoExtCellHistory* aHistory, int aValue)
+{
+    iMock->storm(QStringList(iCellPath), "rsrp", 1, aValue);
+    return TestMetrics::waitFor([aHistory, aValue]() {
+        return aHistory->value(RSRP, 0) == aValue; });
+}
+
+bool TestCellHistory::setRsrp(QOfonoExtCellHistory* aHistory, QList<int> aValues)
+{
+    for (int i = 0; i < aValues.count(); i++) {
+        if (!setRsrp(aHistory, aValues.at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TestCellHistory::statistics()
+{
+    QOfonoExtCell cell(iCellPath);
+    QVERIFY(TestMetrics::waitFor([&cell]() { return cell.valid(); }));
+    QOfonoExtCellHistory history(&cell, 10);
+
+    // The current state is the first sample
+    QCOMPARE(history.count(), 1);
+    QCOMPARE(history.value(RSRP, 0), INITIAL_RSRP);
+
+    QVERIFY(setRsrp(&history, QList<int>() << 100 << 80 << 120 << 95 << 109));
+    QCOMPARE(history.count(), 6);
+    QCOMPARE(history.value(RSRP, 0), 109);
+    QCOMPARE(history.value(RSRP, 2), 120);
+    QCOMPARE(history.value(RSRP, 5), INITIAL_RSRP);
+    QCOMPARE(history.value(RSRP, 6), (int)QOfonoExtCell::InvalidValue);
+    QVERIFY(history.timestamp(0) >= history.timestamp(5));
+
+    // 90 100 80 120 95 109
+    QCOMPARE(history.minimum(RSRP), 80);
+    QCOMPARE(history.maximum(RSRP), 120);
+    QCOMPARE(history.mean(RSRP), 99.0);
+    QCOMPARE(history.percentile(RSRP, 0), 80);
+    QCOMPARE(history.percentile(RSRP, 40), 95);
+    QCOMPARE(history.percentile(RSRP, 100), 120);
+
+    // The other properties don't change
+    QCOMPARE(history.minimum(QOfonoExtCell::PropertyCi), 1000);
+    QCOMPARE(history.maximum(QOfonoExtCell::PropertyCi), 1000);
+
+    // Properties the LTE cell doesn't have
+    QCOMPARE(history.minimum(QOfonoExtCell::PropertyLac),
+        (int)QOfonoExtCell::InvalidValue);
+    QCOMPARE(history.mean(QOfonoExtCell::PropertyLac),
+        (qreal)QOfonoExtCell::InvalidValue);
+    QCOMPARE(history.percentile(QOfonoExtCell::PropertyLac, 50),
+        (int)QOfonoExtCell::InvalidValue);
+
+    // Out of range
+    QCOMPARE(history.minimum(QOfonoExtCell::PropertyCount),
+        (int)QOfonoExtCell::InvalidValue);
+    QCOMPARE(history.value(-1, 0), (int)QOfonoExtCell::InvalidValue);
+}
+
+void TestCellHistory::wraparound()
+{
+    QOfonoExtCell cell(iCellPath);
+    QVERIFY(TestMetrics::waitFor([&cell]() { return cell.valid(); }));
+    QOfonoExtCellHistory history(&cell, 4);
+    QSignalSpy countSpy(&history, SIGNAL(countChanged()));
+
+    // The first sample is the value left by the previous test case
+    QVERIFY(setRsrp(&history, QList<int>() << 50 << 200 << 101 << 102));
+    QCOMPARE(history.count(), 4);
+    QCOMPARE(history.minimum(RSRP), 50);
+    QCOMPARE(history.maximum(RSRP), 200);
+
+    // The oldest samples, including the extremes, fall out
+    QVERIFY(setRsrp(&history, 103));
+    QCOMPARE(history.minimum(RSRP), 101);
+    QCOMPARE(history.maximum(RSRP), 200);
+    QVERIFY(setRsrp(&history, 104));
+    QCOMPARE(history.count(), 4);
+    QCOMPARE(countSpy.count(), 3);
+    QCOMPARE(history.value(RSRP, 0), 104);
+    QCOMPARE(history.value(RSRP, 3), 101);
+    QCOMPARE(history.minimum(RSRP), 101);
+    QCOMPARE(history.maximum(RSRP), 104);
+    QCOMPARE(history.mean(RSRP), 102.5);
+    QCOMPARE(history.percentile(RSRP, 100), 104);
+
+    // Many times around, in both directions
+    QList<int> values;
+    for (int i = 0; i < 10; i++) {
+        values.append(150 - i);
+    }
+    QVERIFY(setRsrp(&history, values));
+    QCOMPARE(history.minimum(RSRP), 141);
+    QCOMPARE(history.maximum(RSRP), 144);
+    QCOMPARE(history.mean(RSRP), 142.5);
+
+    // Changing the capacity drops the history
+    history.setCapacity(8);
+    QCOMPARE(history.capacity(), 8);
+    QCOMPARE(history.count(), 0);
+    QVERIFY(setRsrp(&history, 10));
+    QCOMPARE(history.count(), 1);
+    QCOMPARE(history.minimum(RSRP), 10);
+    QCOMPARE(history.maximum(RSRP), 10);
+}
+
+void TestCellHistory::window()
+{
+    QOfonoExtCell cell(iCellPath);
+    QVERIFY(TestMetrics::waitFor([&cell]() { return cell.valid(); }));
+    QOfonoExtCellHistory history(&cell, 10);
+
+    QVERIFY(setRsrp(&history, QList<int>() << 20 << 200));
+    QTest::qWait(1000);
+    QVERIFY(setRsrp(&history, QList<int>() << 30 << 40 << 50));
+    const int count = history.count();
+
+    // Only the last three samples are less than 500 ms old
+    QCOMPARE(history.minimum(RSRP, 500), 30);
+    QCOMPARE(history.maximum(RSRP, 500), 50);
+    QCOMPARE(history.mean(RSRP, 500), 40.0);
+    QCOMPARE(history.percentile(RSRP, 50, 500), 40);
+
+    // Zero or negative window is the entire history, which starts
+    // with 10 left by the previous test case
+    QCOMPARE(history.minimum(RSRP), 10);
+    QCOMPARE(history.maximum(RSRP, -1), 200);
+    QCOMPARE(history.count(), count);
+
+    // Nothing is that fresh after a while
+    QTest::qWait(200);
+    QCOMPARE(history.minimum(RSRP, 100), (int)QOfonoExtCell::InvalidValue);
+    QCOMPARE(history.mean(RSRP, 100), (qreal)QOfonoExtCell::InvalidValue);
+    QCOMPARE(history.percentile(RSRP, 50, 100),
+        (int)QOfonoExtCell::InvalidValue);
+}
+
+void TestCellHistory::clear()
+{
+    QOfonoExtCell cell(iCellPath);
+    QVERIFY(TestMetrics::waitFor([&cell]() { return cell.valid(); }));
+    QOfonoExtCellHistory history(&cell, 10);
+    QVERIFY(setRsrp(&history, QList<int>() << 70 << 60));
+
+    QSignalSpy countSpy(&history, SIGNAL(countChanged()));
+    history.clear();
+    QCOMPARE(countSpy.count(), 1);
+    QCOMPARE(history.count(), 0);
+    QCOMPARE(history.value(RSRP, 0), (int)QOfonoExtCell::InvalidValue);
+    QCOMPARE(history.minimum(RSRP), (int)QOfonoExtCell::InvalidValue);
+    QCOMPARE(history.maximum(RSRP), (int)QOfonoExtCell::InvalidValue);
+    QCOMPARE(history.mean(RSRP), (qreal)QOfonoExtCell::InvalidValue);
+    QCOMPARE(history.timestamp(0), Q_INT64_C(0));
+
+    // Clearing an empty history changes nothing
+    history.clear();
+    QCOMPARE(countSpy.count(), 1);
+
+    // The old values don't come back
+    QVERIFY(setRsrp(&history, 80));
+    QCOMPARE(history.count(), 1);
+    QCOMPARE(history.minimum(RSRP), 80);
+    QCOMPARE(history.maximum(RSRP), 80);
+    QCOMPARE(history.mean(RSRP), 80.0);
+
+    // Neither does the cell
+    history.setCell(Q_NULLPTR);
+    QCOMPARE(history.count(), 0);
+    QVERIFY(!history.cell());
+}
+
+TESTBUS_MAIN(TestCellHistory)
+
+#include "test_cellhistory.moc"
@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include <QtTest>
+
+#include "qofonoextlistupdate.h"
+
+#include <algorithm>
+#include <random>
+
+class TestListUpdate : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void longestIncreasing_data();
+    void longestIncreasing();
+    void apply_data();
+    void apply();
+    void random();
+
+private:
+    static QStringList rows(const char* aKeys);
+    static bool check(QStringList aRows, QStringList aNewRows,
+        int* aInserts, int* aMoves);
+};
+
+QStringList TestListUpdate::rows(const char* aKeys)
+{
+    QStringList list;
+    for (const char* c = aKeys; *c; c++) {
+        list.append(QString("/ril_%1").arg(QLatin1Char(*c)));
+    }
+    return list;
+}
+
+// Applies the update to a plain list the way the models do, checks
+// that each step is something that beginMoveRows() would accept and
+// that the result is in the right order
+bool TestListUpdate::check(QStringList aRows, QStringList aNewRows,
+    int* aInserts, int* aMoves)
+{
+    bool ok = true;
+    QStringList model(aRows);
+    QOfonoExtListUpdate update(aRows);
+
+    *aInserts = *aMoves = 0;
+    update.apply(aNewRows, [&](int aIndex, int aRow) {
+        if (aRow < 0 || aRow > model.count()) {
+            ok = false;
+        } else {
+            model.insert(aRow, aNewRows.at(aIndex));
+        }
+        (*aInserts)++;
+    }, [&](int aRow, int aDest) {
+        if (aRow < 0 || aRow >= model.count() || aDest < 0 ||
+            aDest > model.count() || aDest == aRow || aDest == aRow + 1) {
+            ok = false;
+        } else {
+            model.move(aRow, (aDest > aRow) ? (aDest - 1) : aDest);
+        }
+        (*aMoves)++;
+    });
+
+    if (ok && model == aNewRows) {
+        for (int i = 0; i < aNewRows.count(); i++) {
+            if (update.row(aNewRows.at(i)) != i) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+void TestListUpdate::longestIncreasing_data()
+{
+    QTest::addColumn<QVector<int> >("values");
+    QTest::addColumn<int>("length");
+
+    QTest::newRow("empty") << QVector<int>() << 0;
+    QTest::newRow("one") << (QVector<int>() << 5) << 1;
+    QTest::newRow("sorted") << (QVector<int>() << 0 << 1 << 2 << 3) << 4;
+    QTest::newRow("reversed") << (QVector<int>() << 3 << 2 << 1 << 0) << 1;
+    QTest::newRow("first out") << (QVector<int>() << 2 << 0 << 1 << 3) << 3;
+    QTest::newRow("mixed") << (QVector<int>() << 0 << 8 << 4 << 12 << 2 <<
+        10 << 6 << 14 << 1 << 9 << 5 << 13 << 3 << 11 << 7 << 15) << 6;
+}
+
+void TestListUpdate::longestIncreasing()
+{
+    QFETCH(QVector<int>, values);
+    QFETCH(int, length);
+
+    const QVector<int> lis(QOfonoExtListUpdate::longestIncreasing(values));
+    QCOMPARE(lis.count(), length);
+    for (int i = 1; i < lis.count(); i++) {
+        QVERIFY(lis.at(i - 1) < lis.at(i));
+        QVERIFY(values.at(lis.at(i - 1)) < values.at(lis.at(i)));
+    }
+}
+
+void TestListUpdate::apply_data()
+{
+    QTest::addColumn<QString>("before");
+    QTest::addColumn<QString>("after");
+    QTest::addColumn<int>("inserts");
+    QTest::addColumn<int>("moves");
+
+    QTest::newRow("no change") << "0123" << "0123" << 0 << 0;
+    QTest::newRow("from empty") << "" << "012" << 3 << 0;
+    QTest::newRow("append") << "012" << "0123" << 1 << 0;
+    QTest::newRow("prepend") << "123" << "0123" << 1 << 0;
+    QTest::newRow("rotate") << "01234" << "12340" << 0 << 1;
+    QTest::newRow("swap") << "01234567" << "01274563" << 0 << 2;
+    QTest::newRow("reverse") << "0123" << "3210" << 0 << 3;
+    QTest::newRow("mixed") << "0246" << "1604253" << 3 << 2;
+}
+
+void TestListUpdate::apply()
+{
+    QFETCH(QString, before);
+    QFETCH(QString, after);
+    QFETCH(int, inserts);
+    QFETCH(int, moves);
+
+    int actualInserts, actualMoves;
+    QVERIFY(check(rows(before.toLatin1().constData()),
+        rows(after.toLatin1().constData()), &actualInserts, &actualMoves));
+    QCOMPARE(actualInserts, inserts);
+    QCOMPARE(actualMoves, moves);
+}
+
+void TestListUpdate::random()
+{
+    // Every row that isn't in the longest run of rows which are already
+    // in order gets exactly one insert or move, and nothing else does
+    std::mt19937 gen(42);
+    const char keys[] = "0123456789abcdef";
+    for (int i = 0; i < 2000; i++) {
+        const int n = gen() % (sizeof(keys) - 1);
+        QByteArray all(keys, n), present;
+        for (int k = 0; k < n; k++) {
+            if (gen() % 3) {
+                present.append(all.at(k));
+            }
+        }
+        std::shuffle(all.begin(), all.end(), gen);
+        std::shuffle(present.begin(), present.end(), gen);
+
+        const QStringList before(rows(present.constData()));
+        const QStringList after(rows(all.constData()));
+        QVector<int> pos;
+        for (int k = 0; k < before.count(); k++) {
+            pos.append(after.indexOf(before.at(k)));
+        }
+        const int stay = QOfonoExtListUpdate::longestIncreasing(pos).count();
+
+        int inserts, moves;
+        QVERIFY2(check(before, after, &inserts, &moves),
+            (present + " => " + all).constData());
+        QCOMPARE(inserts, after.count() - before.count());
+        QCOMPARE(moves, before.count() - stay);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestListUpdate)
+
+#include "test_listupdate.moc"
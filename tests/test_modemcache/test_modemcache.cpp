@@ -0,0 +1,202 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 Jolla Ltd.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include <QtTest>
+
+#include "testbus.h"
+#include "testmetrics.h"
+#include "mockofono.h"
+
+#include "qofonoextmodemmanager.h"
+
+class TestModemCache : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+    void garbage();
+    void roundTrip();
+    void update();
+
+private:
+    static void compare(const QOfonoExtModemState& aCached,
+        const QOfonoExtModemState& aLive);
+    static bool privateFile(QString aPath);
+
+private:
+    MockOfono* iMock;
+    QTemporaryDir* iDir;
+    QString iCacheFile;
+};
+
+void TestModemCache::initTestCase()
+{
+    iMock = new MockOfono;
+    QVERIFY(iMock->start(TestBus::systemBusAddress()));
+    iMock->addModem("/ril_0", "350000000000001", "244910000000001");
+    iMock->addModem("/ril_1", "350000000000002", "244910000000002");
+}
+
+void TestModemCache::cleanupTestCase()
+{
+    QOfonoExtModemManager::setCacheFile(QString());
+    delete iMock;
+    iMock = Q_NULLPTR;
+}
+
+void TestModemCache::init()
+{
+    // The directory gets created when the cache is written
+    iDir = new QTemporaryDir;
+    QVERIFY(iDir->isValid());
+    iCacheFile = iDir->path() + "/cache/modems";
+    QOfonoExtModemManager::setCacheFile(iCacheFile);
+}
+
+void TestModemCache::cleanup()
+{
+    delete iDir;
+    iDir = Q_NULLPTR;
+}
+
+void TestModemCache::compare(const QOfonoExtModemState& aCached,
+    const QOfonoExtModemState& aLive)
+{
+    QCOMPARE(aCached.interfaceVersion, aLive.interfaceVersion);
+    QCOMPARE(aCached.availableModems, aLive.availableModems);
+    QCOMPARE(aCached.enabledModems, aLive.enabledModems);
+    QCOMPARE(aCached.defaultDataModem, aLive.defaultDataModem);
+    QCOMPARE(aCached.defaultVoiceModem, aLive.defaultVoiceModem);
+    QCOMPARE(aCached.defaultDataSim, aLive.defaultDataSim);
+    QCOMPARE(aCached.defaultVoiceSim, aLive.defaultVoiceSim);
+    QCOMPARE(aCached.presentSims, aLive.presentSims);
+    QCOMPARE(aCached.imeiCodes, aLive.imeiCodes);
+    QCOMPARE(aCached.imeisvCodes, aLive.imeisvCodes);
+    QCOMPARE(aCached.mmsSim, aLive.mmsSim);
+    QCOMPARE(aCached.mmsModem, aLive.mmsModem);
+    QCOMPARE(aCached.ready, aLive.ready);
+    QCOMPARE(aCached.presentSimCount, aLive.presentSimCount);
+    QCOMPARE(aCached.activeSimCount, aLive.activeSimCount);
+}
+
+bool TestModemCache::privateFile(QString aPath)
+{
+    const QFileDevice::Permissions others(QFileDevice::ReadGroup |
+        QFileDevice::WriteGroup | QFileDevice::ExeGroup |
+        QFileDevice::ReadOther | QFileDevice::WriteOther |
+        QFileDevice::ExeOther);
+    const QFileDevice::Permissions perm(QFile::permissions(aPath));
+    return (perm & QFileDevice::ReadOwner) &&
+        (perm & QFileDevice::WriteOwner) && !(perm & others);
+}
+
+void TestModemCache::garbage()
+{
+    // Whatever is in the file gets ignored and replaced, and so do
+    // the permissions
+    QVERIFY(QDir().mkpath(QFileInfo(iCacheFile).absolutePath()));
+    QFile file(iCacheFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write("MMGC but not really") > 0);
+    file.close();
+    QVERIFY(file.setPermissions(QFileDevice::ReadOwner |
+        QFileDevice::WriteOwner | QFileDevice::ReadGroup |
+        QFileDevice::ReadOther));
+
+    QOfonoExtModemManager* manager = new QOfonoExtModemManager;
+    QVERIFY(!manager->stale());
+    QVERIFY(manager->availableModems().isEmpty());
+    QVERIFY(TestMetrics::waitFor([manager]() { return manager->valid(); }));
+    QVERIFY(!manager->stale());
+    delete manager;
+
+    QVERIFY(QFile::exists(iCacheFile));
+    QVERIFY(privateFile(iCacheFile));
+}
+
+void TestModemCache::roundTrip()
+{
+    // Nothing to load the first time
+    QOfonoExtModemManager* manager = new QOfonoExtModemManager;
+    QVERIFY(!manager->stale());
+    QVERIFY(TestMetrics::waitFor([manager]() { return manager->valid(); }));
+    const QOfonoExtModemState live(manager->state());
+    QCOMPARE(live.availableModems.count(), 2);
+    QCOMPARE(live.imeiCodes.count(), 2);
+    delete manager;
+
+    QVERIFY(QFile::exists(iCacheFile));
+    QVERIFY(privateFile(iCacheFile));
+
+    // Everything is there right after construction, before anything
+    // has been received from the bus
+    manager = new QOfonoExtModemManager;
+    QSignalSpy staleSpy(manager, SIGNAL(staleChanged(bool)));
+    const QOfonoExtModemState cached(manager->state());
+    QVERIFY(!manager->valid());
+    QVERIFY(manager->stale());
+    QVERIFY(cached.stale);
+    compare(cached, live);
+    QVERIFY(!QTest::currentTestFailed());
+
+    // The snapshot for other threads says the same
+    QSharedPointer<const QOfonoExtModemState> shared(manager->sharedState());
+    QVERIFY(shared);
+    QVERIFY(shared->stale);
+    compare(*shared, live);
+    QVERIFY(!QTest::currentTestFailed());
+
+    // Until the live state arrives
+    QVERIFY(TestMetrics::waitFor([manager]() { return manager->valid(); }));
+    QVERIFY(!manager->stale());
+    QCOMPARE(staleSpy.count(), 1);
+    QCOMPARE(staleSpy.at(0).at(0).toBool(), false);
+    compare(manager->state(), live);
+    QVERIFY(!QTest::currentTestFailed());
+    delete manager;
+}
+
+void TestModemCache::update()
+{
+    QOfonoExtModemManager* manager = new QOfonoExtModemManager;
+    QVERIFY(TestMetrics::waitFor([manager]() { return manager->valid(); }));
+
+    // The changes received after the last GetAll are written on exit
+    const QStringList wasEnabled(manager->enabledModems());
+    const QStringList enabled(QStringList() << "/ril_1");
+    QVERIFY(wasEnabled != enabled);
+    iMock->emitEnabledModemsChanged(enabled);
+    QVERIFY(TestMetrics::waitFor([manager,enabled]() {
+        return manager->enabledModems() == enabled; }));
+    const QOfonoExtModemState live(manager->state());
+    delete manager;
+
+    manager = new QOfonoExtModemManager;
+    QVERIFY(manager->stale());
+    QCOMPARE(manager->enabledModems(), enabled);
+    compare(manager->state(), live);
+    QVERIFY(!QTest::currentTestFailed());
+    delete manager;
+
+    // Leave the mock the way the other cases expect it
+    iMock->emitEnabledModemsChanged(wasEnabled);
+}
+
+TESTBUS_MAIN(TestModemCache)
+
+#include "test_modemcache.moc"